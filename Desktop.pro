@@ -66,33 +66,58 @@ RESOURCES += $$PWD/etc/resources/desktop/resources.qrc
 HEADERS += \
     $$PWD/src/desktop/include/AdvancedSettings.h \
     $$PWD/src/desktop/include/AssemblyInfo.h \
+    $$PWD/src/desktop/include/AxisConditioner.h \
     $$PWD/src/desktop/include/Battery.h \
+    $$PWD/src/desktop/include/Charts.h \
+    $$PWD/src/desktop/include/ChartSeries.h \
+    $$PWD/src/desktop/include/ChartView.h \
     $$PWD/src/desktop/include/CpuUsage.h \
     $$PWD/src/desktop/include/Dashboard.h \
     $$PWD/src/desktop/include/GamepadManager.h \
+    $$PWD/src/desktop/include/HostMetrics.h \
     $$PWD/src/desktop/include/InitTasks.h \
+    $$PWD/src/desktop/include/JoystickView.h \
     $$PWD/src/desktop/include/Joysticks.h \
     $$PWD/src/desktop/include/MainWindow.h \
+    $$PWD/src/desktop/include/Performance.h \
     $$PWD/src/desktop/include/Settings.h \
-    $$PWD/src/desktop/include/SmartWindow.h
+    $$PWD/src/desktop/include/SmartWindow.h \
+    $$PWD/src/desktop/include/Startup.h \
+    $$PWD/src/desktop/include/TelemetryExporter.h \
+    $$PWD/src/desktop/include/TelemetryStore.h \
+    $$PWD/src/desktop/include/Watchdog.h \
+    $$PWD/src/desktop/include/WidgetUpdater.h
 
 SOURCES += \
     $$PWD/src/desktop/sources/AdvancedSettings.cpp \
     $$PWD/src/desktop/sources/AssemblyInfo.cpp \
+    $$PWD/src/desktop/sources/AxisConditioner.cpp \
     $$PWD/src/desktop/sources/Battery.cpp \
+    $$PWD/src/desktop/sources/Charts.cpp \
+    $$PWD/src/desktop/sources/ChartSeries.cpp \
+    $$PWD/src/desktop/sources/ChartView.cpp \
     $$PWD/src/desktop/sources/CpuUsage.cpp \
     $$PWD/src/desktop/sources/Dashboard.cpp \
     $$PWD/src/desktop/sources/GamepadManager.cpp \
+    $$PWD/src/desktop/sources/HostMetrics.cpp \
     $$PWD/src/desktop/sources/InitTasks.cpp \
+    $$PWD/src/desktop/sources/JoystickView.cpp \
     $$PWD/src/desktop/sources/Joysticks.cpp \
     $$PWD/src/desktop/sources/main.cpp \
     $$PWD/src/desktop/sources/MainWindow.cpp \
+    $$PWD/src/desktop/sources/Performance.cpp \
     $$PWD/src/desktop/sources/Settings.cpp \
-    $$PWD/src/desktop/sources/SmartWindow.cpp
+    $$PWD/src/desktop/sources/SmartWindow.cpp \
+    $$PWD/src/desktop/sources/Startup.cpp \
+    $$PWD/src/desktop/sources/TelemetryExporter.cpp \
+    $$PWD/src/desktop/sources/TelemetryStore.cpp \
+    $$PWD/src/desktop/sources/Watchdog.cpp \
+    $$PWD/src/desktop/sources/WidgetUpdater.cpp
 
 FORMS += \
     $$PWD/src/desktop/forms/Joysticks.ui \
     $$PWD/src/desktop/forms/MainWindow.ui \
+    $$PWD/src/desktop/forms/Performance.ui \
     $$PWD/src/desktop/forms/AdvancedSettings.ui
 
 #-------------------------------------------------------------------------------
@@ -145,6 +170,9 @@ macx* {
 
 linux:!android {
     LIBS += -lSDL2
+
+    # Export the symbols so that the watchdog can print readable stacks
+    QMAKE_LFLAGS += -rdynamic
 }
 
 #-------------------------------------------------------------------------------
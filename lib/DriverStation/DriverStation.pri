@@ -34,20 +34,33 @@ INCLUDEPATH += $$PWD/include
 HEADERS += \
     $$PWD/include/DriverStation.h \
     $$PWD/src/Common.h \
+    $$PWD/src/ConsoleExporter.h \
+    $$PWD/src/ConsoleFilter.h \
+    $$PWD/src/ConsoleStore.h \
     $$PWD/src/NetConsole.h \
     $$PWD/src/NetworkDiagnostics.h \
     $$PWD/src/Packets.h \
+    $$PWD/src/Profiler.h \
+    $$PWD/src/RateController.h \
+    $$PWD/src/RobotLink.h \
+    $$PWD/src/SideChannel.h \
     $$PWD/src/VersionAnalyzer.h
 
 SOURCES += \
     $$PWD/src/Common.cpp \
+    $$PWD/src/ConsoleExporter.cpp \
+    $$PWD/src/ConsoleFilter.cpp \
+    $$PWD/src/ConsoleStore.cpp \
     $$PWD/src/DriverStation.cpp \
     $$PWD/src/NetConsole.cpp \
     $$PWD/src/NetworkDiagnostics.cpp \
     $$PWD/src/Packets.cpp \
+    $$PWD/src/Profiler.cpp \
+    $$PWD/src/RateController.cpp \
+    $$PWD/src/RobotLink.cpp \
+    $$PWD/src/SideChannel.cpp \
     $$PWD/src/VersionAnalyzer.cpp
 
-
-
-
-
+win32* {
+    LIBS += -lPsapi
+}
@@ -23,16 +23,25 @@
 #ifndef _DRIVER_STATION_MAIN_H
 #define _DRIVER_STATION_MAIN_H
 
-#include <QTime>
 #include <QObject>
 #include <QTcpSocket>
 #include <QStringList>
+#include <QElapsedTimer>
 #include <QNetworkReply>
 
 #include "../src/Common.h"
 #include "../src/NetConsole.h"
+#include "../src/Profiler.h"
+#include "../src/RateController.h"
+#include "../src/RobotLink.h"
+#include "../src/SideChannel.h"
+#include "../src/ConsoleStore.h"
+#include "../src/ConsoleFilter.h"
 
 class NetConsole;
+class DS_Profiler;
+class DS_RobotLink;
+class DS_ConsoleStore;
 class DS_VersionAnalyzer;
 class DS_NetworkDiagnostics;
 
@@ -77,11 +86,66 @@ public:
      */
     Q_INVOKABLE DS_ControlMode operationMode();
 
+    /**
+     * Returns a copy of the latest snapshot of the robot state, which
+     * contains the communication status, control mode, voltage, versions
+     * and resource usage of the robot
+     */
+    Q_INVOKABLE DS_State state();
+
+    /**
+     * Returns the time (in milliseconds) at which the current control mode
+     * was started, measured with a monotonic clock that is not affected by
+     * changes in the system time.
+     *
+     * The value is only meaningful when compared with other values returned
+     * by this function, use \c elapsedTime() to get the match time
+     */
+    Q_INVOKABLE qint64 modeStartTime();
+
+    /**
+     * Returns the number of milliseconds that have passed since the robot was
+     * switched to its current control mode. The value stops increasing when
+     * the robot is disabled and is reset when another mode is selected.
+     *
+     * Use \c DS_GetElapsedTimeString() to display the value to the user
+     */
+    Q_INVOKABLE qint64 elapsedTime();
+
     /**
      * Returns the single instance of the NetConsole
      */
     Q_INVOKABLE NetConsole* netConsole();
 
+    /**
+     * Returns the model that stores the messages received by the NetConsole
+     */
+    Q_INVOKABLE DS_ConsoleStore* consoleStore();
+
+    /**
+     * Returns the profiler that measures the timer lateness, event loop
+     * latency and resource usage of the application
+     */
+    Q_INVOKABLE DS_Profiler* profiler();
+
+    /**
+     * Returns the object that exchanges packets with the roboRIO and counts
+     * the lost packets and their round trip time
+     */
+    Q_INVOKABLE DS_RobotLink* robotLink();
+
+    /**
+     * Returns the TCP channel used to send the data that rarely changes,
+     * such as the joystick descriptors and the match information
+     */
+    Q_INVOKABLE DS_SideChannel* sideChannel();
+
+    /**
+     * Returns the object that adapts the rate of the control packets to the
+     * quality of the link
+     */
+    Q_INVOKABLE DS_RateController* rateController();
+
     /**
      * Returns the IP address of the robot radio
      */
@@ -144,14 +208,34 @@ public slots:
      *     - DS_Autonomous
      *     - DS_EmergencyStop
      *
-     * @note The elapsed time will be reset when the mode is switched
+     * @note The elapsed time will be reset when the mode is switched, and it
+     *       will stop increasing when the robot is disabled
      */
     Q_INVOKABLE void setControlMode (DS_ControlMode mode);
 
     /**
-     * [TODO]
+     * Replaces the joystick states that are sent to the robot with each
+     * control packet. The position of each joystick in the list is its
+     * port number, only the first six joysticks are sent to the robot
+     */
+    Q_INVOKABLE void putJoystickData (QList<DS_JoystickData> joysticks);
+
+    /**
+     * Changes the names and input counts of the joysticks that are reported
+     * to the robot. They are only sent when they change
      */
-    Q_INVOKABLE void putJoystickData (DS_JoystickData joystickData);
+    Q_INVOKABLE void putJoystickDescriptors (QList<DS_JoystickDescriptor>
+                                             joysticks);
+
+    /**
+     * Changes the game-specific message that is reported to the robot
+     */
+    Q_INVOKABLE void setGameData (QString data);
+
+    /**
+     * Changes the match information that is reported to the robot
+     */
+    Q_INVOKABLE void setMatchInfo (DS_MatchInfo info);
 
     /**
      * Simulates a timed match with the input time values (in seconds)
@@ -160,6 +244,16 @@ public slots:
                                     int delay, int teleop, int endgame);
 
 signals:
+    /**
+     * Emitted once for every batch of changes in the robot state. The
+     * \a fields value is a combination of \c DS_StateField flags that
+     * tells which fields of \a state changed since the last emission.
+     *
+     * Prefer this signal over the individual signals below when you need
+     * to update several widgets or values at the same time
+     */
+    void stateChanged (DS_State state, int fields);
+
     /**
      * Emitted when the client detects that the availability of the robot
      * software/code has changed
@@ -228,12 +322,6 @@ signals:
      */
     void diskUsageChanged (int total, int used);
 
-    /**
-     * Emitted when the robot is enabled and the elapsed time
-     * has been updated by the library.
-     */
-    void elapsedTimeChanged (QString elapsedTime);
-
 protected:
     /**
      * Initializes the private variables of the class.
@@ -251,7 +339,9 @@ private:
     bool m_justConnected;
     bool m_justDisconnected;
 
-    QTime m_time;
+    qint64 m_modeStart;
+    qint64 m_frozenTime;
+    QElapsedTimer m_clock;
     QString m_oldStatus;
     QString m_newStatus;
 
@@ -259,10 +349,56 @@ private:
     DS_Alliance m_alliance;
     DS_ControlMode m_controlMode;
 
+    DS_State m_state;
+    int m_dirtyFields;
+
+    QList<DS_JoystickData> m_joysticks;
+
+    DS_RobotLink* m_robotLink;
+    DS_SideChannel* m_sideChannel;
+    DS_RateController* m_rateController;
+    DS_ConsoleStore* m_consoleStore;
     DS_VersionAnalyzer* m_versionAnalyzer;
     DS_NetworkDiagnostics* m_netDiagnostics;
 
+    /**
+     * @internal
+     * Marks the given \c DS_StateField flags as changed and schedules the
+     * emission of the \c stateChanged() signal, so that all the changes
+     * made during the same event loop iteration are published together
+     */
+    void markDirty (int fields);
+
 private slots:
+    /**
+     * @internal
+     * Increments the version of the state snapshot and emits the
+     * \c stateChanged() signal with the fields changed since the last call
+     */
+    void publishState();
+
+    /**
+     * @internal
+     * Stores the versions reported by the version analyzer in the state
+     * snapshot and forwards them to the individual signals
+     */
+    void onLibVersionChanged (QString version);
+    void onRioVersionChanged (QString version);
+    void onPdpVersionChanged (QString version);
+    void onPcmVersionChanged (QString version);
+
+    /**
+     * @internal
+     * Writes the decisions of the rate controller to the console log
+     */
+    void onRateDecision (DS_RateDecision decision);
+
+    /**
+     * @internal
+     * Reads the status and telemetry of the robot into the state snapshot
+     */
+    void onPacketReceived (QByteArray packet);
+
     /**
      * Returns a string with the current status of the robot.
      * Possible return values can be:
@@ -276,13 +412,29 @@ private slots:
      */
     QString getStatus();
 
+    /**
+     * Emits the \c robotStatusChanged() signal if the status of the robot
+     * is different from the last emitted status. Called when the connection,
+     * code or control mode of the robot changes.
+     */
+    void updateStatus();
+
+    /**
+     * @internal
+     * Downloads the library, PDP and PCM versions from the roboRIO, if we
+     * are still connected to it. Called a couple of seconds after the
+     * connection is established, so that the FTP transfers do not compete
+     * with the first control packets
+     */
+    void downloadRobotInformation();
+
     /**
      * Checks if the connection between the roboRIO and the client is
      * working correctly by "pinging" the roboRIO with a TCP/IP connection.
      *
      * If the function detects that the client just connected to the roboRIO,
-     * it downloads robot information using FTP and analyzes the downloaded
-     * information to emit singals to connected objects.
+     * it schedules the download of the robot information using FTP, which is
+     * then analyzed to emit singals to connected objects.
      *
      * If the function detects that the client just disconnected from the
      * roboRIO, it updates all the internal values to prevent sending data
@@ -306,15 +458,6 @@ private slots:
      * This function is called once every 20 milliseconds.
      */
     void sendPacketsToRobot();
-
-    /**
-     * @internal
-     * Updates the elapsed time with the time that has passed since the user
-     * enabled the robot.
-     *
-     * @note The timer is reset when the control mode is changed
-     */
-    void updateElapsedTime();
 };
 
 #endif /* _DRIVER_STATION_MAIN_H */
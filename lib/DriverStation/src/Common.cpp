@@ -47,3 +47,18 @@ QString DS_GetControlModeString (DS_ControlMode mode)
 
     return "ERR_INVALID_CONTROL_MODE";
 }
+
+QString DS_GetElapsedTimeString (qint64 msecs)
+{
+    if (msecs < 0)
+        msecs = 0;
+
+    qint64 minutes = msecs / 60000;
+    qint64 seconds = (msecs / 1000) % 60;
+    qint64 tenths = (msecs / 100) % 10;
+
+    return QString ("%1:%2.%3")
+           .arg (minutes, 2, 10, QChar ('0'))
+           .arg (seconds, 2, 10, QChar ('0'))
+           .arg (tenths);
+}
@@ -23,7 +23,9 @@
 #ifndef _DRIVER_STATION_COMMON_H
 #define _DRIVER_STATION_COMMON_H
 
-class QString;
+#include <QList>
+#include <QString>
+#include <QMetaType>
 
 /**
  * Represents the available operation modes of the robot.
@@ -66,17 +68,122 @@ enum DS_Alliance {
  * Represents a joystick and its current state.
  * The idea behind this is that the program will record the current state
  * of a joystick and fill this structure with its data, which then
- * will be processed by the library and sent to the robot
+ * will be processed by the library and sent to the robot.
+ *
+ * The robot accepts up to 12 axes, 32 buttons and 4 POVs for each joystick,
+ * any extra value is ignored by the library
  */
 struct DS_JoystickData {
-    int id;              /**< The joysticks that are attached */
-    double axis_value;   /**< The values of each joystick axis */
-    bool button_pressed; /**< The states of each joystick button */
+    QList<double> axes;  /**< The values of each axis, from -1 to 1 */
+    QList<bool> buttons; /**< The states of each joystick button */
+    QList<int> povs;     /**< The angle of each POV, -1 if not pressed */
+};
+
+/**
+ * Describes a joystick to the robot program. Unlike \c DS_JoystickData,
+ * the descriptors rarely change, so they are sent through the TCP channel
+ * only when a joystick is attached or removed
+ */
+struct DS_JoystickDescriptor {
+    QString name;   /**< The name of the joystick */
+    int numAxes;    /**< The number of axes that the joystick has */
+    int numButtons; /**< The number of buttons that the joystick has */
+    int numPovs;    /**< The number of POVs that the joystick has */
+};
+
+/**
+ * Represents the types of match that can be reported to the robot
+ */
+enum DS_MatchType {
+    DS_NoMatch = 0,            /**< Not playing a match */
+    DS_PracticeMatch = 1,      /**< Practice match */
+    DS_QualificationMatch = 2, /**< Qualification match */
+    DS_EliminationMatch = 3    /**< Elimination match */
+};
+
+/**
+ * Describes the match that the robot is playing
+ */
+struct DS_MatchInfo {
+    QString eventName;  /**< The name of the event */
+    DS_MatchType type;  /**< The type of the match */
+    int number;         /**< The number of the match */
+    int replay;         /**< The number of times the match was replayed */
+};
+
+/**
+ * Identifies the fields of a \c DS_State snapshot. The \c stateChanged()
+ * signal of the \c DriverStation reports a combination of these values to
+ * tell the receiver which fields are different from the last snapshot
+ */
+enum DS_StateField {
+    DS_CodeField = 0x001,        /**< Availability of the robot code */
+    DS_NetworkField = 0x002,     /**< Availability of the roboRIO */
+    DS_RadioField = 0x004,       /**< Availability of the robot radio */
+    DS_ControlModeField = 0x008, /**< Control mode of the robot */
+    DS_AllianceField = 0x010,    /**< Alliance and position of the robot */
+    DS_StatusField = 0x020,      /**< User-friendly status string */
+    DS_VoltageField = 0x040,     /**< Battery voltage of the robot */
+    DS_LibVersionField = 0x080,  /**< Version of the WPI library */
+    DS_RioVersionField = 0x100,  /**< Version of the roboRIO image */
+    DS_PdpVersionField = 0x200,  /**< Version of the PDP firmware */
+    DS_PcmVersionField = 0x400,  /**< Version of the PCM firmware */
+    DS_RamUsageField = 0x800,    /**< RAM usage of the roboRIO */
+    DS_DiskUsageField = 0x1000,  /**< Disk usage of the roboRIO */
+    DS_CpuUsageField = 0x2000,   /**< CPU usage of the roboRIO */
+    DS_CanUsageField = 0x4000,   /**< Utilization of the CAN bus */
+    DS_PdpCurrentField = 0x8000, /**< Currents measured by the PDP */
+    DS_AllFields = 0xffff        /**< Used to force a full update */
+};
+
+/**
+ * Holds everything that the library knows about the robot at a given
+ * moment. Instead of listening to a dozen of signals that may arrive in any
+ * order, an application can read a single snapshot and be sure that all
+ * its fields belong to the same update.
+ *
+ * The \c version is incremented every time that the library publishes a
+ * new snapshot, so it can be used to discard stale copies
+ */
+struct DS_State {
+    quint32 version;             /**< Incremented with each new snapshot */
+
+    bool code;                   /**< \c true if the robot code is running */
+    bool network;                /**< \c true if the roboRIO is reachable */
+    bool radio;                  /**< \c true if the radio is reachable */
+
+    DS_ControlMode controlMode;  /**< The current operation mode */
+    DS_Alliance alliance;        /**< The current alliance and position */
+    QString status;              /**< Same as \c robotStatusChanged() */
+
+    float voltage;               /**< Battery voltage of the robot */
+
+    QString libVersion;          /**< WPI library version */
+    QString rioVersion;          /**< roboRIO image version */
+    QString pdpVersion;          /**< PDP firmware version */
+    QString pcmVersion;          /**< PCM firmware version */
+
+    int ramTotal;                /**< Total RAM (MB) of the roboRIO */
+    int ramUsed;                 /**< Used RAM (MB) of the roboRIO */
+    int diskTotal;               /**< Total disk space (MB) of the roboRIO */
+    int diskUsed;                /**< Used disk space (MB) of the roboRIO */
+
+    int cpuUsage;                /**< CPU usage (%) of the roboRIO */
+    float canUtilization;        /**< Utilization (%) of the CAN bus */
+    float pdpCurrents[16];       /**< Current (A) of each PDP channel */
 };
 
+Q_DECLARE_METATYPE (DS_State)
+
 /**
  * Returns an user-friendly string given the inputed robot control mode
  */
 QString DS_GetControlModeString (DS_ControlMode mode);
 
+/**
+ * Returns the given amount of milliseconds in the 'mm:ss.z' format used by
+ * the elapsed time display (eg. '01:12.3')
+ */
+QString DS_GetElapsedTimeString (qint64 msecs);
+
 #endif /* _DRIVER_STATION_COMMON_H */
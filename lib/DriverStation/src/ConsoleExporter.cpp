@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QFile>
+#include <QString>
+
+#include "ConsoleExporter.h"
+
+DS_ConsoleExporter::DS_ConsoleExporter (const DS_ConsoleStore::Chunks& chunks,
+                                        const QString& path,
+                                        DS_ConsoleStore::ExportFormat format,
+                                        QObject* parent) : QThread (parent)
+{
+    m_path = path;
+    m_chunks = chunks;
+    m_format = format;
+}
+
+void DS_ConsoleExporter::run()
+{
+    QFile file (m_path);
+    if (!file.open (QFile::WriteOnly | QFile::Truncate)) {
+        emit exportFinished (false, m_path);
+        return;
+    }
+
+    int count = 0;
+    foreach (const DS_ConsoleStore::Chunk& chunk, m_chunks)
+        count += chunk.rows.count();
+
+    int index = 0;
+    int percent = -1;
+
+    QByteArray output;
+    foreach (const DS_ConsoleStore::Chunk& chunk, m_chunks) {
+        output.clear();
+        output.reserve (chunk.buffer.length() * 2);
+
+        for (int i = 0; i < chunk.rows.count(); ++i, ++index)
+            writeRow (index, chunk.buffer, chunk.rows.at (i), output);
+
+        if (file.write (output) != output.length()) {
+            file.close();
+            emit exportFinished (false, m_path);
+            return;
+        }
+
+        if ((index * 100) / count != percent) {
+            percent = (index * 100) / count;
+            emit progressChanged (percent);
+        }
+    }
+
+    file.close();
+    emit progressChanged (100);
+    emit exportFinished (true, m_path);
+}
+
+void DS_ConsoleExporter::writeRow (int index,
+                                   const QByteArray& buffer,
+                                   const DS_ConsoleStore::Row& row,
+                                   QByteArray& output)
+{
+    const char* data = buffer.constData() + row.offset;
+    QByteArray text = QByteArray::fromRawData (data, row.length);
+
+    /* Replace invalid sequences so that the output is always valid UTF-8 */
+    if (row.encoding == DS_ConsoleStore::Invalid)
+        text = QString::fromUtf8 (text).toUtf8();
+
+    if (m_format == DS_ConsoleStore::PlainText) {
+        output.append (text);
+        output.append ('\n');
+        return;
+    }
+
+    /* JSON lines, escape the text by hand to avoid building JSON objects */
+    output.append ("{\"line\":");
+    output.append (QByteArray::number (index + 1));
+    output.append (",\"text\":\"");
+
+    for (int i = 0; i < text.length(); ++i) {
+        unsigned char c = text.at (i);
+
+        switch (c) {
+        case '"':
+            output.append ("\\\"");
+            break;
+        case '\\':
+            output.append ("\\\\");
+            break;
+        case '\n':
+            output.append ("\\n");
+            break;
+        case '\r':
+            output.append ("\\r");
+            break;
+        case '\t':
+            output.append ("\\t");
+            break;
+        default:
+            if (c < 0x20) {
+                char escape[8];
+                qsnprintf (escape, sizeof (escape), "\\u%04x", c);
+                output.append (escape);
+            }
+
+            else
+                output.append ((char) c);
+            break;
+        }
+    }
+
+    output.append ("\"}\n");
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_CONSOLE_EXPORTER_H
+#define _DRIVER_STATION_CONSOLE_EXPORTER_H
+
+#include <QThread>
+#include <QString>
+#include <QByteArray>
+
+#include "ConsoleStore.h"
+
+/**
+ * \class DS_ConsoleExporter
+ *
+ * Writes a snapshot of the NetConsole history to a file from a background
+ * thread. The export shares the sealed chunks of the store, and they are
+ * converted and written one at a time, so that the memory used by the
+ * export does not depend on the size of the history.
+ */
+class DS_ConsoleExporter : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Prepares an export of the messages in the given \a chunks to the file
+     * located in \a path
+     */
+    explicit DS_ConsoleExporter (const DS_ConsoleStore::Chunks& chunks,
+                                 const QString& path,
+                                 DS_ConsoleStore::ExportFormat format,
+                                 QObject* parent = 0);
+
+signals:
+    /**
+     * Emitted each time that the percentage of exported messages changes
+     */
+    void progressChanged (int percent);
+
+    /**
+     * Emitted when the export is complete or when the file cannot be written
+     */
+    void exportFinished (bool success, QString path);
+
+protected:
+    /**
+     * @internal
+     * Writes the messages to the file, one chunk at a time
+     */
+    void run();
+
+private:
+    QString m_path;
+    DS_ConsoleStore::Chunks m_chunks;
+    DS_ConsoleStore::ExportFormat m_format;
+
+    /**
+     * @internal
+     * Appends the message described by \a row, which is stored in \a buffer,
+     * to the \a output, formatted and terminated with a new line
+     */
+    void writeRow (int index,
+                   const QByteArray& buffer,
+                   const DS_ConsoleStore::Row& row,
+                   QByteArray& output);
+};
+
+#endif /* _DRIVER_STATION_CONSOLE_EXPORTER_H */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "ConsoleStore.h"
+#include "ConsoleFilter.h"
+
+DS_ConsoleFilter::DS_ConsoleFilter (DS_ConsoleStore* store,
+                                    QObject* parent) :
+    QSortFilterProxyModel (parent)
+{
+    m_store = store;
+    setSourceModel (store);
+}
+
+QString DS_ConsoleFilter::pattern() const
+{
+    return m_pattern;
+}
+
+void DS_ConsoleFilter::setPattern (QString pattern)
+{
+    if (m_pattern == pattern)
+        return;
+
+    m_pattern = pattern;
+    m_bytes = pattern.toUtf8();
+    invalidateFilter();
+}
+
+bool DS_ConsoleFilter::filterAcceptsRow (int row,
+                                         const QModelIndex& parent) const
+{
+    Q_UNUSED (parent);
+
+    if (m_bytes.isEmpty())
+        return true;
+
+    return m_store->contains (row, m_bytes);
+}
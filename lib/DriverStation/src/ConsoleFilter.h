@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _DRIVER_STATION_CONSOLE_FILTER_H
+#define _DRIVER_STATION_CONSOLE_FILTER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QSortFilterProxyModel>
+
+class DS_ConsoleStore;
+
+/**
+ * \class DS_ConsoleFilter
+ *
+ * Shows the messages of a \c DS_ConsoleStore that contain a given text.
+ * The text is matched against the raw bytes of each message, so that the
+ * history does not need to be decoded every time that the filter changes.
+ */
+class DS_ConsoleFilter : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit DS_ConsoleFilter (DS_ConsoleStore* store, QObject* parent = 0);
+
+    /**
+     * Returns the text that the visible messages must contain
+     */
+    QString pattern() const;
+
+public slots:
+    /**
+     * Changes the text that the visible messages must contain and filters
+     * the store again. An empty \a pattern shows all the messages.
+     */
+    void setPattern (QString pattern);
+
+protected:
+    /**
+     * @internal
+     * Returns \c true if the message in \a row contains the current pattern
+     */
+    bool filterAcceptsRow (int row, const QModelIndex& parent) const;
+
+private:
+    QString m_pattern;
+    QByteArray m_bytes;
+    DS_ConsoleStore* m_store;
+};
+
+#endif /* _DRIVER_STATION_CONSOLE_FILTER_H */
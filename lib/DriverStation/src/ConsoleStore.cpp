@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ConsoleStore.h"
+#include "ConsoleExporter.h"
+
+/* Maximum number of messages kept before the oldest ones are removed */
+#define _MAX_ROWS 500000
+
+/* Number of messages stored in each chunk before it is sealed */
+#define _CHUNK_ROWS 4096
+
+Q_STATIC_ASSERT (sizeof (DS_ConsoleStore::Row) == 8);
+
+/**
+ * Returns the index of the first byte after \a i that is not ASCII.
+ * The bytes are checked 16 at a time with SSE2, or 8 at a time on other
+ * architectures, which is where most of the console text is handled.
+ */
+static int skipAscii (const unsigned char* data, int i, int length)
+{
+#if defined __SSE2__
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128 ((const __m128i*) (data + i));
+        if (_mm_movemask_epi8 (block) != 0)
+            break;
+    }
+#else
+    for (; i + 8 <= length; i += 8) {
+        quint64 block;
+        memcpy (&block, data + i, sizeof (block));
+        if (block & Q_UINT64_C (0x8080808080808080))
+            break;
+    }
+#endif
+
+    while (i < length && data[i] < 0x80)
+        ++i;
+
+    return i;
+}
+
+/**
+ * Returns the encoding of the given message, rejecting overlong sequences,
+ * surrogates and code points above U+10FFFF
+ */
+static quint8 classify (const char* message, int length)
+{
+    const unsigned char* data = (const unsigned char*) message;
+
+    int i = skipAscii (data, 0, length);
+    if (i == length)
+        return DS_ConsoleStore::Ascii;
+
+    while (i < length) {
+        unsigned char c = data[i];
+
+        int count;
+        quint32 min;
+        quint32 codepoint;
+
+        if ((c & 0xE0) == 0xC0) {
+            count = 1;
+            min = 0x80;
+            codepoint = c & 0x1F;
+        }
+
+        else if ((c & 0xF0) == 0xE0) {
+            count = 2;
+            min = 0x800;
+            codepoint = c & 0x0F;
+        }
+
+        else if ((c & 0xF8) == 0xF0) {
+            count = 3;
+            min = 0x10000;
+            codepoint = c & 0x07;
+        }
+
+        else
+            return DS_ConsoleStore::Invalid;
+
+        if (i + count >= length)
+            return DS_ConsoleStore::Invalid;
+
+        for (int j = 1; j <= count; ++j) {
+            if ((data[i + j] & 0xC0) != 0x80)
+                return DS_ConsoleStore::Invalid;
+
+            codepoint = (codepoint << 6) | (data[i + j] & 0x3F);
+        }
+
+        if (codepoint < min || codepoint > 0x10FFFF
+                || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+            return DS_ConsoleStore::Invalid;
+
+        i = skipAscii (data, i + count + 1, length);
+    }
+
+    return DS_ConsoleStore::Utf8;
+}
+
+/**
+ * Returns the lowercase version of \a c if it is an ASCII letter, multi-byte
+ * sequences are left untouched so that they can be compared byte by byte
+ */
+static inline char foldAscii (char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+DS_ConsoleStore::DS_ConsoleStore (QObject* parent) : QAbstractListModel (parent)
+{
+    m_count = 0;
+}
+
+int DS_ConsoleStore::rowCount (const QModelIndex& parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_count;
+}
+
+QVariant DS_ConsoleStore::data (const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_count)
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return message (index.row());
+
+    return QVariant();
+}
+
+QString DS_ConsoleStore::message (int row) const
+{
+    if (row < 0 || row >= m_count)
+        return QString();
+
+    const QByteArray* buffer;
+    const Row& r = locate (row, &buffer);
+    const char* data = buffer->constData() + r.offset;
+
+    if (r.encoding == Ascii)
+        return QString::fromLatin1 (data, r.length);
+
+    return QString::fromUtf8 (data, r.length);
+}
+
+QByteArray DS_ConsoleStore::rawMessage (int row) const
+{
+    if (row < 0 || row >= m_count)
+        return QByteArray();
+
+    const QByteArray* buffer;
+    const Row& r = locate (row, &buffer);
+    return QByteArray (buffer->constData() + r.offset, r.length);
+}
+
+bool DS_ConsoleStore::contains (int row, const QByteArray& pattern) const
+{
+    if (row < 0 || row >= m_count)
+        return false;
+
+    const QByteArray* buffer;
+    const Row& r = locate (row, &buffer);
+    const char* data = buffer->constData() + r.offset;
+
+    int size = pattern.length();
+    const char* needle = pattern.constData();
+
+    for (int i = 0; i + size <= (int) r.length; ++i) {
+        int j = 0;
+        while (j < size && foldAscii (data[i + j]) == foldAscii (needle[j]))
+            ++j;
+
+        if (j == size)
+            return true;
+    }
+
+    return false;
+}
+
+void DS_ConsoleStore::append (QList<QByteArray> messages)
+{
+    if (messages.isEmpty())
+        return;
+
+    if (m_count + messages.count() > _MAX_ROWS)
+        trim();
+
+    beginInsertRows (QModelIndex(), m_count, m_count + messages.count() - 1);
+
+    foreach (const QByteArray& message, messages) {
+        int length = message.length();
+
+        /* Do not store the line terminators sent by the robot */
+        while (length > 0 && (message.at (length - 1) == '\n'
+                              || message.at (length - 1) == '\r'))
+            --length;
+
+        /* Seal the last chunk when it is full and start a new one */
+        if (m_chunks.isEmpty() || m_chunks.last().rows.count() == _CHUNK_ROWS) {
+            m_chunks.append (Chunk());
+            m_chunks.last().rows.reserve (_CHUNK_ROWS);
+        }
+
+        Chunk& chunk = m_chunks.last();
+
+        Row row;
+        row.offset = chunk.buffer.length();
+        row.length = length;
+        row.encoding = classify (message.constData(), length);
+
+        chunk.rows.append (row);
+        chunk.buffer.append (message.constData(), length);
+        ++m_count;
+    }
+
+    endInsertRows();
+}
+
+void DS_ConsoleStore::append (QString message)
+{
+    append (QList<QByteArray>() << message.toUtf8());
+}
+
+void DS_ConsoleStore::clear()
+{
+    beginResetModel();
+    m_count = 0;
+    m_chunks.clear();
+    endResetModel();
+}
+
+void DS_ConsoleStore::exportToFile (QString path, ExportFormat format)
+{
+    /* The sealed chunks are shared, only the last one is copied on write */
+    DS_ConsoleExporter* exporter = new DS_ConsoleExporter (m_chunks, path,
+                                                           format, this);
+
+    connect (exporter, SIGNAL (progressChanged (int)),
+             this,     SIGNAL (exportProgress (int)));
+    connect (exporter, SIGNAL (exportFinished (bool, QString)),
+             this,     SIGNAL (exportFinished (bool, QString)));
+    connect (exporter, SIGNAL (finished()),
+             exporter, SLOT   (deleteLater()));
+
+    exporter->start (QThread::LowPriority);
+}
+
+const DS_ConsoleStore::Row& DS_ConsoleStore::locate (
+    int row, const QByteArray** buffer) const
+{
+    const Chunk& chunk = m_chunks.at (row / _CHUNK_ROWS);
+    *buffer = &chunk.buffer;
+    return chunk.rows.at (row % _CHUNK_ROWS);
+}
+
+void DS_ConsoleStore::trim()
+{
+    /* Every chunk but the last one is full */
+    int chunks = m_chunks.count() / 2;
+    if (chunks <= 0)
+        return;
+
+    int rows = chunks * _CHUNK_ROWS;
+
+    beginRemoveRows (QModelIndex(), 0, rows - 1);
+    m_chunks.erase (m_chunks.begin(), m_chunks.begin() + chunks);
+    m_count -= rows;
+    endRemoveRows();
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_CONSOLE_STORE_H
+#define _DRIVER_STATION_CONSOLE_STORE_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QAbstractListModel>
+
+/**
+ * \class DS_ConsoleStore
+ *
+ * The DS_ConsoleStore class keeps the history of the NetConsole as raw bytes
+ * and exposes it as a list model.
+ *
+ * The messages are stored in fixed-size chunks. Only the last chunk is
+ * written to, once it is full it is sealed and never modified again, which
+ * allows exports to share the history without copying it.
+ *
+ * Each message is classified (ASCII, valid UTF-8 or invalid) when it is
+ * stored, but it is only converted to a \c QString when a view asks for it,
+ * which usually means that the row is being painted, copied or exported.
+ */
+class DS_ConsoleStore : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit DS_ConsoleStore (QObject* parent = 0);
+
+    /**
+     * Represents the encoding of a stored message, which is detected when
+     * the message is added to the store
+     */
+    enum Encoding {
+        Ascii = 0,   /**< Only 7-bit characters, decoded as Latin-1 */
+        Utf8 = 1,    /**< Valid multi-byte UTF-8 text */
+        Invalid = 2  /**< Malformed text, invalid sequences are replaced */
+    };
+
+    /**
+     * Represents the file formats supported by \c exportToFile()
+     */
+    enum ExportFormat {
+        PlainText = 0, /**< One message per line */
+        JsonLines = 1  /**< One JSON object per line */
+    };
+
+    /**
+     * Describes where a message is located inside the buffer and how it
+     * should be decoded. The encoding is kept in the two high bits of the
+     * length, so that each row only takes 8 bytes.
+     */
+    struct Row {
+        quint32 offset;
+        quint32 length   : 30;
+        quint32 encoding : 2;
+    };
+
+    typedef QVector<Row> Rows;
+
+    /**
+     * Holds the raw bytes of a group of consecutive messages and the rows
+     * that point to them
+     */
+    struct Chunk {
+        QByteArray buffer;
+        Rows rows;
+    };
+
+    typedef QList<Chunk> Chunks;
+
+    /**
+     * Returns the number of messages in the store
+     */
+    int rowCount (const QModelIndex& parent = QModelIndex()) const;
+
+    /**
+     * Returns the decoded message of the \a index for the display role
+     */
+    QVariant data (const QModelIndex& index, int role = Qt::DisplayRole) const;
+
+    /**
+     * Returns the decoded message at the given \a row
+     */
+    QString message (int row) const;
+
+    /**
+     * Returns the raw bytes of the message at the given \a row
+     */
+    QByteArray rawMessage (int row) const;
+
+    /**
+     * Returns \c true if the raw bytes of the message at the given \a row
+     * contain the \a pattern, ignoring the case of ASCII letters.
+     * The message is not decoded, which keeps filtering cheap.
+     */
+    bool contains (int row, const QByteArray& pattern) const;
+
+public slots:
+    /**
+     * Appends the raw \a messages to the store
+     */
+    void append (QList<QByteArray> messages);
+
+    /**
+     * Appends a single \a message generated by the application
+     */
+    void append (QString message);
+
+    /**
+     * Removes all the messages from the store
+     */
+    void clear();
+
+    /**
+     * Writes all the messages to the file in \a path from a background
+     * thread. The export works on a snapshot of the store, so new messages
+     * can be received while the file is written.
+     */
+    void exportToFile (QString path, ExportFormat format);
+
+signals:
+    /**
+     * Emitted periodically while an export is running
+     */
+    void exportProgress (int percent);
+
+    /**
+     * Emitted when an export started with \c exportToFile() finishes
+     */
+    void exportFinished (bool success, QString path);
+
+private:
+    int m_count;
+    Chunks m_chunks;
+
+    /**
+     * @internal
+     * Returns the row descriptor of the given message \a row and sets
+     * \a buffer to the bytes of the chunk that contains it
+     */
+    const Row& locate (int row, const QByteArray** buffer) const;
+
+    /**
+     * @internal
+     * Removes the oldest half of the chunks when the store is full
+     */
+    void trim();
+};
+
+#endif /* _DRIVER_STATION_CONSOLE_STORE_H */
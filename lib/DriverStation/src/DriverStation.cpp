@@ -21,18 +21,23 @@
  */
 
 #include <QTimer>
+#include <string.h>
 #include <DriverStation.h>
 
 #include "Packets.h"
 #include "VersionAnalyzer.h"
 #include "NetworkDiagnostics.h"
 
+/* Milliseconds to wait before downloading the versions after connecting */
+#define _VERSION_DELAY 2000
+
 DriverStation* DriverStation::m_instance = nullptr;
 
 DriverStation::DriverStation()
 {
     m_code = false;
     m_init = false;
+    m_radioStatus = false;
     m_oldConnection = false;
     m_justConnected = false;
     m_justDisconnected = false;
@@ -41,17 +46,53 @@ DriverStation::DriverStation()
     m_alliance = DS_Red1;
     m_controlMode = DS_Disabled;
 
+    m_state.version = 0;
+    m_state.code = false;
+    m_state.network = false;
+    m_state.radio = false;
+    m_state.controlMode = m_controlMode;
+    m_state.alliance = m_alliance;
+    m_state.voltage = 0;
+    m_state.ramTotal = 0;
+    m_state.ramUsed = 0;
+    m_state.diskTotal = 0;
+    m_state.diskUsed = 0;
+    m_state.cpuUsage = 0;
+    m_state.canUtilization = 0;
+    memset (m_state.pdpCurrents, 0, sizeof (m_state.pdpCurrents));
+    m_dirtyFields = 0;
+
+    m_modeStart = 0;
+    m_frozenTime = 0;
+    m_clock.start();
+
+    qRegisterMetaType<DS_State> ("DS_State");
+
+    m_robotLink = new DS_RobotLink (this);
+    m_sideChannel = new DS_SideChannel (this);
+    m_rateController = new DS_RateController (this);
+    m_consoleStore = new DS_ConsoleStore (this);
     m_versionAnalyzer = new DS_VersionAnalyzer();
     m_netDiagnostics = new DS_NetworkDiagnostics();
 
-    connect (m_versionAnalyzer, SIGNAL (libVersionChanged (QString)),
-             this,              SIGNAL (libVersionChanged (QString)));
-    connect (m_versionAnalyzer, SIGNAL (pcmVersionChanged (QString)),
-             this,              SIGNAL (pcmVersionChanged (QString)));
-    connect (m_versionAnalyzer, SIGNAL (pdpVersionChanged (QString)),
-             this,              SIGNAL (pdpVersionChanged (QString)));
-    connect (m_versionAnalyzer, SIGNAL (rioVersionChanged (QString)),
-             this,              SIGNAL (rioVersionChanged (QString)));
+    connect (netConsole(),   SIGNAL (newMessages (QList<QByteArray>)),
+             m_consoleStore, SLOT   (append (QList<QByteArray>)));
+
+    connect (m_robotLink, SIGNAL (packetReceived   (QByteArray)),
+             this,        SLOT   (onPacketReceived (QByteArray)));
+    connect (m_robotLink,      SIGNAL (statsChanged (DS_LinkStats)),
+             m_rateController, SLOT   (update       (DS_LinkStats)));
+    connect (m_rateController, SIGNAL (decisionMade   (DS_RateDecision)),
+             this,             SLOT   (onRateDecision (DS_RateDecision)));
+
+    connect (m_versionAnalyzer, SIGNAL (libVersionChanged   (QString)),
+             this,              SLOT   (onLibVersionChanged (QString)));
+    connect (m_versionAnalyzer, SIGNAL (pcmVersionChanged   (QString)),
+             this,              SLOT   (onPcmVersionChanged (QString)));
+    connect (m_versionAnalyzer, SIGNAL (pdpVersionChanged   (QString)),
+             this,              SLOT   (onPdpVersionChanged (QString)));
+    connect (m_versionAnalyzer, SIGNAL (rioVersionChanged   (QString)),
+             this,              SLOT   (onRioVersionChanged (QString)));
 }
 
 DriverStation* DriverStation::getInstance()
@@ -86,11 +127,54 @@ DS_ControlMode DriverStation::operationMode()
     return m_controlMode;
 }
 
+DS_State DriverStation::state()
+{
+    return m_state;
+}
+
+qint64 DriverStation::modeStartTime()
+{
+    return m_modeStart;
+}
+
+qint64 DriverStation::elapsedTime()
+{
+    if (m_controlMode == DS_Disabled)
+        return m_frozenTime;
+
+    return m_clock.elapsed() - m_modeStart;
+}
+
 NetConsole* DriverStation::netConsole()
 {
     return NetConsole::getInstance();
 }
 
+DS_ConsoleStore* DriverStation::consoleStore()
+{
+    return m_consoleStore;
+}
+
+DS_Profiler* DriverStation::profiler()
+{
+    return DS_Profiler::getInstance();
+}
+
+DS_RobotLink* DriverStation::robotLink()
+{
+    return m_robotLink;
+}
+
+DS_SideChannel* DriverStation::sideChannel()
+{
+    return m_sideChannel;
+}
+
+DS_RateController* DriverStation::rateController()
+{
+    return m_rateController;
+}
+
 QString DriverStation::roboRioAddress()
 {
     return m_netDiagnostics->roboRioIpAddress();
@@ -113,17 +197,18 @@ void DriverStation::init()
         emit pdpVersionChanged ("");
         emit ramUsageChanged (0, 0);
         emit diskUsageChanged (0, 0);
+        markDirty (DS_AllFields);
 
         /* Begin DS/Communication loop */
+        m_robotLink->init();
         checkConnection();
         sendPacketsToRobot();
 
-        /* Start the elapsed time loop */
-        updateElapsedTime();
-        emit elapsedTimeChanged ("00:00.0");
+        /* Measure the responsiveness of the GUI thread */
+        profiler()->init();
 
-        /* Initialize the NetConsole */
-        netConsole()->init();
+        /* Initialize the NetConsole in its own thread */
+        QMetaObject::invokeMethod (netConsole(), "init", Qt::QueuedConnection);
 
         /* This code will only run once */
         m_init = true;
@@ -147,7 +232,11 @@ void DriverStation::setTeamNumber (int team)
 
 void DriverStation::setAlliance (DS_Alliance alliance)
 {
-    m_alliance = alliance;
+    if (m_alliance != alliance) {
+        m_alliance = alliance;
+        m_state.alliance = alliance;
+        markDirty (DS_AllianceField);
+    }
 }
 
 void DriverStation::setCustomAddress (QString address)
@@ -157,15 +246,40 @@ void DriverStation::setCustomAddress (QString address)
 
 void DriverStation::setControlMode (DS_ControlMode mode)
 {
-    if (m_controlMode != mode && mode != DS_Disabled)
-        m_time.restart();
+    if (m_controlMode != mode) {
+        /* Stop the match clock or restart it for the new mode */
+        if (mode == DS_Disabled)
+            m_frozenTime = elapsedTime();
+        else
+            m_modeStart = m_clock.elapsed();
+
+        m_controlMode = mode;
+        m_state.controlMode = mode;
+        markDirty (DS_ControlModeField);
+    }
 
-    m_controlMode = mode;
+    updateStatus();
 }
 
-void DriverStation::putJoystickData (DS_JoystickData joystickData)
+void DriverStation::putJoystickData (QList<DS_JoystickData> joysticks)
 {
-    Q_UNUSED (joystickData);
+    m_joysticks = joysticks;
+}
+
+void DriverStation::putJoystickDescriptors (QList<DS_JoystickDescriptor>
+                                            joysticks)
+{
+    m_sideChannel->setJoystickDescriptors (joysticks);
+}
+
+void DriverStation::setGameData (QString data)
+{
+    m_sideChannel->setGameData (data);
+}
+
+void DriverStation::setMatchInfo (DS_MatchInfo info)
+{
+    m_sideChannel->setMatchInfo (info);
 }
 
 void DriverStation::startPractice (int countdown,
@@ -192,8 +306,108 @@ QString DriverStation::getStatus()
     return DS_GetControlModeString (m_controlMode);
 }
 
+void DriverStation::updateStatus()
+{
+    m_newStatus = getStatus();
+
+    if (m_newStatus != m_oldStatus) {
+        m_oldStatus = m_newStatus;
+        m_state.status = m_newStatus;
+
+        markDirty (DS_StatusField);
+        emit robotStatusChanged (m_newStatus);
+    }
+}
+
+void DriverStation::markDirty (int fields)
+{
+    /* Only schedule a publication for the first change of the batch */
+    if (m_dirtyFields == 0)
+        QTimer::singleShot (0, this, SLOT (publishState()));
+
+    m_dirtyFields |= fields;
+}
+
+void DriverStation::publishState()
+{
+    if (m_dirtyFields == 0)
+        return;
+
+    int fields = m_dirtyFields;
+    m_dirtyFields = 0;
+
+    ++m_state.version;
+    emit stateChanged (m_state, fields);
+}
+
+void DriverStation::onLibVersionChanged (QString version)
+{
+    m_state.libVersion = version;
+    markDirty (DS_LibVersionField);
+    emit libVersionChanged (version);
+}
+
+void DriverStation::onRioVersionChanged (QString version)
+{
+    m_state.rioVersion = version;
+    markDirty (DS_RioVersionField);
+    emit rioVersionChanged (version);
+}
+
+void DriverStation::onPdpVersionChanged (QString version)
+{
+    m_state.pdpVersion = version;
+    markDirty (DS_PdpVersionField);
+    emit pdpVersionChanged (version);
+}
+
+void DriverStation::onPcmVersionChanged (QString version)
+{
+    m_state.pcmVersion = version;
+    markDirty (DS_PcmVersionField);
+    emit pcmVersionChanged (version);
+}
+
+void DriverStation::onRateDecision (DS_RateDecision decision)
+{
+    QString message = tr ("INFO: %1 (packets every %2 ms)")
+                      .arg (decision.reason).arg (decision.interval);
+
+    if (decision.latency >= 0)
+        message.append (tr (", loss %1%, round trip %2 ms")
+                        .arg (decision.lossRate).arg (decision.latency));
+
+    m_consoleStore->append (message);
+}
+
+void DriverStation::onPacketReceived (QByteArray packet)
+{
+    int fields = DS_ReadRobotPacket (packet, &m_state);
+    if (fields == 0)
+        return;
+
+    markDirty (fields);
+
+    if (fields & DS_VoltageField)
+        emit voltageChanged (m_state.voltage);
+
+    if (fields & DS_RamUsageField)
+        emit ramUsageChanged (m_state.ramTotal, m_state.ramUsed);
+
+    if (fields & DS_DiskUsageField)
+        emit diskUsageChanged (m_state.diskTotal, m_state.diskUsed);
+}
+
+void DriverStation::downloadRobotInformation()
+{
+    if (m_netDiagnostics->roboRioIsAlive())
+        m_versionAnalyzer->downloadRobotInformation (roboRioAddress());
+}
+
 void DriverStation::checkConnection()
 {
+    profiler()->timerFired ("Connection check");
+
     m_netDiagnostics->refresh();
 
     m_justConnected = m_netDiagnostics->roboRioIsAlive() && !m_oldConnection;
@@ -201,77 +415,58 @@ void DriverStation::checkConnection()
 
     if (m_justDisconnected) {
         m_code = false;
+        m_state.code = false;
+        m_state.network = false;
+
+        markDirty (DS_CodeField | DS_NetworkField);
         emit codeChanged (m_code);
         emit networkChanged (false);
+
+        m_sideChannel->setAddress ("");
     }
 
     else if (m_justConnected) {
+        m_state.network = true;
+
+        markDirty (DS_NetworkField);
         emit networkChanged (true);
-        m_versionAnalyzer->downloadRobotInformation (roboRioAddress());
+
+        m_sideChannel->setAddress (roboRioAddress());
+
+        /* Let the control packets go first, the versions can wait */
+        QTimer::singleShot (_VERSION_DELAY, this,
+                            SLOT (downloadRobotInformation()));
     }
 
     m_oldConnection = m_netDiagnostics->roboRioIsAlive();
 
     if (m_radioStatus != m_netDiagnostics->robotRadioIsAlive()) {
         m_radioStatus = m_netDiagnostics->robotRadioIsAlive();
+        m_state.radio = m_radioStatus;
 
+        markDirty (DS_RadioField);
         emit radioChanged (m_radioStatus);
     }
 
+    updateStatus();
+
+    profiler()->timerScheduled ("Connection check", 500);
     QTimer::singleShot (500, this, SLOT (checkConnection()));
 }
 
 void DriverStation::sendPacketsToRobot()
 {
-    emit robotStatusChanged (getStatus());
+    profiler()->timerFired ("Robot packets");
 
     if (m_netDiagnostics->roboRioIsAlive()) {
-        DS_SendCommonControlPacket (m_status,
-                                    m_alliance,
-                                    m_controlMode,
-                                    roboRioAddress());
-    }
-
-    QTimer::singleShot (20, this, SLOT (sendPacketsToRobot()));
-}
-
-void DriverStation::updateElapsedTime()
-{
-    /*
-     * We are a bunch of lazy motherfuckers,
-     * and we only work when required
-     */
-    if (operationMode() != DS_Disabled) {
-
-        /* Get milliseconds, seconds and minutes */
-        int time = m_time.elapsed();
-        int nSeconds = time / 1000;
-        int nMinutes = nSeconds / 60;
-
-        /* Avoid having "01:72.0" instead of "01:12.0" */
-        while (nSeconds >= 60)
-            nSeconds -= 60;
-
-        /* Create strings */
-        QString seconds = QString ("%1").arg (nSeconds);
-        QString minutes = QString ("%1").arg (nMinutes);
-        QString milliseconds = QString ("%1").arg (time);
-
-        /* Prepend 0 if seconds are less than 10 */
-        if (nSeconds < 10)
-            seconds = "0" + seconds;
-
-        /* Prepend 0 if minutes are less than 10 */
-        if (nMinutes < 10)
-            minutes = "0" + minutes;
-
-        /* Notify other objects that the elapsed time has changed */
-        emit elapsedTimeChanged (QString ("%1:%2.%3")
-                                 .arg (minutes)
-                                 .arg (seconds)
-                                 .arg (milliseconds.at (
-                                           milliseconds.length() - 1)));
+        m_robotLink->sendControlPacket (m_status,
+                                        m_alliance,
+                                        m_controlMode,
+                                        roboRioAddress(),
+                                        m_joysticks);
     }
 
-    QTimer::singleShot (5, this, SLOT (updateElapsedTime()));
+    int interval = m_rateController->interval();
+    profiler()->timerScheduled ("Robot packets", interval);
+    QTimer::singleShot (interval, this, SLOT (sendPacketsToRobot()));
 }
@@ -20,8 +20,22 @@
  * THE SOFTWARE.
  */
 
+#include <QHash>
+#include <QMetaType>
 #include <QTimer>
+#include <QThread>
 #include <QUdpSocket>
+#include <QCoreApplication>
+
+#include <string.h>
+
+#if defined __gnu_linux__
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <QSocketNotifier>
+#endif
 
 #include "NetConsole.h"
 
@@ -29,15 +43,57 @@
 #define _UDP_IN_PORT 6666
 #define _UDP_OUT_PORT 6668
 
+/* Default number of messages emitted each second before sampling */
+#define _DEFAULT_BUDGET 200
+
+/* When the budget is exceeded, only one of every N messages is emitted */
+#define _SAMPLE_RATE 50
+
+/* Number of datagrams read from the kernel in a single batch */
+#define _BATCH_SIZE 64
+
+/* Longer datagrams are truncated, the roboRIO never sends them anyway */
+#define _MAX_DATAGRAM_SIZE 2048
+
 /* THIS FILE WAS NOT TESTED, IT WILL MOST PROBABLY NEED TO BE CHANGED! */
 
+/*
+ * Buffer pool used to read datagrams without allocating memory for each one.
+ * There is only one instance of the NetConsole, so we can keep them here.
+ */
+static char buffers[_BATCH_SIZE][_MAX_DATAGRAM_SIZE];
+
+#if defined __gnu_linux__
+static struct iovec vectors[_BATCH_SIZE];
+static struct mmsghdr headers[_BATCH_SIZE];
+#endif
+
 NetConsole* NetConsole::m_instance = nullptr;
 
 NetConsole::NetConsole()
 {
+    m_socket = -1;
+    m_notifier = nullptr;
+
     m_inSocket = new QUdpSocket (this);
     m_outSocket = new QUdpSocket (this);
+
+    m_budget.store (_DEFAULT_BUDGET);
+    m_received = 0;
+    m_dropped = 0;
+    m_lastHash = 0;
+    m_repeatCount = 0;
+
+    qRegisterMetaType<QList<QByteArray> > ("QList<QByteArray>");
     connect (m_inSocket, SIGNAL (readyRead()), this, SLOT (onMessageReceived()));
+
+    /* Read and parse the messages outside of the GUI thread */
+    m_thread = new QThread();
+    moveToThread (m_thread);
+    connect (QCoreApplication::instance(), SIGNAL (aboutToQuit()),
+             m_thread,                     SLOT   (quit()));
+
+    m_thread->start();
 }
 
 NetConsole* NetConsole::getInstance()
@@ -48,23 +104,180 @@ NetConsole* NetConsole::getInstance()
     return m_instance;
 }
 
+int NetConsole::messageBudget()
+{
+    return m_budget.load();
+}
+
+void NetConsole::setMessageBudget (int budget)
+{
+    if (budget >= 0)
+        m_budget.store (budget);
+}
+
 void NetConsole::init()
 {
     m_address.setAddress ("255.255.255.255");
-    m_inSocket->bind (m_address, _UDP_IN_PORT);
     m_outSocket->bind (m_address, _UDP_OUT_PORT);
 
-    emit newMessage ("INFO: Welcome to the QDriverStation!");
-    emit newMessage ("");
+#if defined __gnu_linux__
+    for (int i = 0; i < _BATCH_SIZE; ++i) {
+        vectors[i].iov_base = buffers[i];
+        vectors[i].iov_len = _MAX_DATAGRAM_SIZE;
+
+        memset (&headers[i], 0, sizeof (headers[i]));
+        headers[i].msg_hdr.msg_iov = &vectors[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    /* Use a native socket so that we can read whole batches with recvmmsg */
+    m_socket = socket (AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+
+    if (m_socket >= 0) {
+        int reuse = 1;
+        setsockopt (m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse));
+
+        struct sockaddr_in address;
+        memset (&address, 0, sizeof (address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons (_UDP_IN_PORT);
+        address.sin_addr.s_addr = htonl (INADDR_ANY);
+
+        if (bind (m_socket, (struct sockaddr*) &address, sizeof (address)) == 0) {
+            m_notifier = new QSocketNotifier (m_socket,
+                                              QSocketNotifier::Read,
+                                              this);
+            connect (m_notifier, SIGNAL (activated (int)),
+                     this,       SLOT   (onMessageReceived()));
+        }
+
+        else {
+            close (m_socket);
+            m_socket = -1;
+        }
+    }
+
+    /* Fallback to the Qt socket if something went wrong */
+    if (m_socket < 0)
+        m_inSocket->bind (m_address, _UDP_IN_PORT);
+#else
+    m_inSocket->bind (m_address, _UDP_IN_PORT);
+#endif
+
+    queueMessage ("INFO: Welcome to the QDriverStation!");
+    queueMessage ("");
+
+    flush();
 }
 
 void NetConsole::onMessageReceived()
 {
+#if defined __gnu_linux__
+    if (m_socket >= 0) {
+        int count = 0;
+
+        /* Drain the kernel queue, one batch at a time */
+        do {
+            count = recvmmsg (m_socket, headers, _BATCH_SIZE, MSG_DONTWAIT,
+                              nullptr);
+
+            for (int i = 0; i < count; ++i)
+                processMessage (buffers[i], headers[i].msg_len);
+        } while (count == _BATCH_SIZE);
+
+        sendMessages();
+        return;
+    }
+#endif
+
     while (m_inSocket->hasPendingDatagrams()) {
-        QByteArray datagram;
-        datagram.resize (m_inSocket->pendingDatagramSize());
-        m_inSocket->readDatagram (datagram.data(), datagram.size());
+        qint64 length = m_inSocket->readDatagram (buffers[0],
+                                                  _MAX_DATAGRAM_SIZE);
+
+        if (length > 0)
+            processMessage (buffers[0], length);
+    }
+
+    sendMessages();
+}
+
+bool NetConsole::withinBudget()
+{
+    ++m_received;
+
+    int budget = m_budget.load();
+    if (budget == 0 || m_received <= budget)
+        return true;
+
+    /* Over budget, let a sample of the messages through */
+    if ((m_received - budget) % _SAMPLE_RATE == 0)
+        return true;
+
+    ++m_dropped;
+    return false;
+}
+
+void NetConsole::processMessage (const char* data, int length)
+{
+    uint hash = qHashBits (data, length);
+
+    /* Same message as before, only count it */
+    if (hash == m_lastHash
+            && length == m_lastMessage.length()
+            && memcmp (data, m_lastMessage.constData(), length) == 0) {
+        ++m_repeatCount;
+        m_lastSeen = QTime::currentTime();
+        return;
+    }
+
+    /* The message changed, report the repetitions of the previous one */
+    reportRepetitions();
 
-        emit newMessage (QString::fromUtf8 (datagram));
+    /* Reuse the buffer of the last message, the queue shares it, so it is
+     * only copied again if the previous message is still queued */
+    m_lastHash = hash;
+    m_lastMessage.resize (length);
+    memcpy (m_lastMessage.data(), data, length);
+
+    if (withinBudget())
+        queueMessage (m_lastMessage);
+}
+
+void NetConsole::reportRepetitions()
+{
+    if (m_repeatCount > 0) {
+        queueMessage (tr ("INFO: Last message repeated %1 times "
+                          "(last seen at %2)")
+                      .arg (m_repeatCount)
+                      .arg (m_lastSeen.toString ("hh:mm:ss.zzz")).toUtf8());
+        m_repeatCount = 0;
+    }
+}
+
+void NetConsole::queueMessage (const QByteArray& message)
+{
+    m_pending.append (message);
+}
+
+void NetConsole::sendMessages()
+{
+    if (!m_pending.isEmpty()) {
+        emit newMessages (m_pending);
+        m_pending.clear();
     }
 }
+
+void NetConsole::flush()
+{
+    reportRepetitions();
+
+    if (m_dropped > 0) {
+        queueMessage (tr ("INFO: %1 lines dropped").arg (m_dropped).toUtf8());
+        m_dropped = 0;
+    }
+
+    sendMessages();
+
+    m_received = 0;
+    QTimer::singleShot (1000, this, SLOT (flush()));
+}
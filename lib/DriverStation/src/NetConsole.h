@@ -23,12 +23,18 @@
 #ifndef _DRIVER_STATION_NET_CONSOLE_H
 #define _DRIVER_STATION_NET_CONSOLE_H
 
+#include <QList>
+#include <QTime>
 #include <QString>
 #include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
 #include <QHostAddress>
 
+class QThread;
 class QUdpSocket;
 class DriverStation;
+class QSocketNotifier;
 
 class NetConsole : public QObject
 {
@@ -42,11 +48,32 @@ public slots:
      */
     static NetConsole* getInstance();
 
+    /**
+     * Returns the maximum number of messages that the NetConsole will emit
+     * each second before it starts sampling the incoming messages
+     */
+    int messageBudget();
+
+    /**
+     * Changes the maximum number of messages that will be emitted each second.
+     * Once the budget is exceeded, only a fraction of the incoming messages
+     * will be emitted and a 'N lines dropped' message will be emitted at the
+     * end of each second.
+     *
+     * A \a budget of 0 disables the rate limiter
+     */
+    void setMessageBudget (int budget);
+
 signals:
     /**
-     * Emitted when a new UDP datagram is received on the input port
+     * Emitted when one or more UDP datagrams are received on the input port.
+     * The \a messages contain the raw bytes sent by the robot, which are
+     * expected (but not guaranteed) to be UTF-8 text.
+     *
+     * \note The NetConsole runs in its own thread, so this signal is delivered
+     *       to objects that live in the GUI thread through a queued connection
      */
-    void newMessage (QString message);
+    void newMessages (QList<QByteArray> messages);
 
 protected:
     explicit NetConsole();
@@ -58,13 +85,74 @@ private:
     QUdpSocket* m_inSocket;
     QUdpSocket* m_outSocket;
 
+    int m_socket;
+    QThread* m_thread;
+    QSocketNotifier* m_notifier;
+
+    QAtomicInt m_budget;
+    int m_received;
+    int m_dropped;
+
+    uint m_lastHash;
+    int m_repeatCount;
+    QTime m_lastSeen;
+    QByteArray m_lastMessage;
+    QList<QByteArray> m_pending;
+
+    /**
+     * @internal
+     * Returns \c true if the current message should be emitted without
+     * exceeding the message budget of the current second
+     */
+    bool withinBudget();
+
+    /**
+     * @internal
+     * Collapses repeated messages into a counter and applies the message budget
+     * before emitting the \a data to the connected objects
+     */
+    void processMessage (const char* data, int length);
+
+    /**
+     * @internal
+     * Emits a single message that tells how many times the last message was
+     * repeated and when it was last seen
+     */
+    void reportRepetitions();
+
+    /**
+     * @internal
+     * Adds the \a message to the list of messages that will be emitted by
+     * the next call to \c sendMessages()
+     */
+    void queueMessage (const QByteArray& message);
+
+    /**
+     * @internal
+     * Emits all the queued messages with a single signal, so that a whole
+     * batch of datagrams only needs one event to reach the GUI thread
+     */
+    void sendMessages();
+
 private slots:
     /**
      * @internal
-     * Parses the received data and emits a singal to connected objects
+     * Reads all the pending datagrams in batches and parses them.
+     * On Linux, the datagrams are read with \c recvmmsg() into a pool of
+     * pre-allocated buffers to avoid one system call and one memory allocation
+     * for each received message.
      */
     void onMessageReceived();
 
+    /**
+     * @internal
+     * Emits the 'repeated N times' and 'N lines dropped' messages that were
+     * accumulated since the last call and resets the message budget.
+     *
+     * This function is called once every second.
+     */
+    void flush();
+
     /**
      * Sends a welcome message to the connected objects and starts
      * the UDP broadcasting/listening process.
@@ -20,41 +20,311 @@
  * THE SOFTWARE.
  */
 
-#include <QString>
-#include <QPointer>
-#include <QDateTime>
 #include <QByteArray>
-#include <QUdpSocket>
-#include <QHostAddress>
+
+#include <string.h>
 
 #include "Packets.h"
 
-#define _NET_ROBORIO_PORT 1110
-#define _NET_DRIVER_STATION_PORT 1150
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* The joystick limits of the FRC 2015 protocol */
+#define _MAX_JOYSTICKS 6
+#define _MAX_AXES 12
+#define _MAX_BUTTONS 32
+#define _MAX_POVS 4
+
+/* The tag that identifies the joystick data in the control packet */
+#define _JOYSTICK_TAG 0x0c
+
+/* Size of the header of the robot packets, before the extended sections */
+#define _ROBOT_HEADER_SIZE 8
 
 /* NOT TESTED, IT WILL BE CHANGED FOR SURE */
 
-QByteArray DS_CommonControlPacket (DS_Status status, DS_Alliance alliance,
-                                   DS_ControlMode mode)
+QByteArray DS_CommonControlPacket (quint16 index, DS_Status status,
+                                   DS_Alliance alliance, DS_ControlMode mode,
+                                   const QList<DS_JoystickData>& joysticks)
 {
     QByteArray packet;
+    int count = qMin (joysticks.count(), _MAX_JOYSTICKS);
+
+    /* Gather the axes of all the joysticks and quantize them at once */
+    double values[_MAX_JOYSTICKS * _MAX_AXES];
+    qint8 axes[_MAX_JOYSTICKS * _MAX_AXES];
+    int numAxes[_MAX_JOYSTICKS];
+    int total = 0;
 
-    packet.append ('0');
-    packet.append ('0');
-    packet.append ('0');
+    for (int i = 0; i < count; ++i) {
+        const QList<double>& list = joysticks.at (i).axes;
+        numAxes[i] = qMin (list.count(), _MAX_AXES);
+
+        for (int j = 0; j < numAxes[i]; ++j)
+            values[total++] = list.at (j);
+    }
+
+    DS_QuantizeAxes (values, axes, total);
+
+    /* Reserve the header and the largest possible joystick tags */
+    packet.reserve (6 + count * (5 + _MAX_AXES + 4 + _MAX_POVS * 2));
+
+    packet.append (static_cast<char> (index >> 8));
+    packet.append (static_cast<char> (index & 0xff));
+    packet.append (0x01);
     packet.append (mode);
     packet.append (status);
     packet.append (alliance);
 
+    const qint8* axis = axes;
+    for (int i = 0; i < count; ++i) {
+        const DS_JoystickData& joystick = joysticks.at (i);
+        int numButtons = qMin (joystick.buttons.count(), _MAX_BUTTONS);
+        int numPovs = qMin (joystick.povs.count(), _MAX_POVS);
+        int buttonBytes = (numButtons + 7) / 8;
+
+        /* The first button is the least significant bit of the last byte */
+        quint32 buttons = 0;
+        for (int j = 0; j < numButtons; ++j) {
+            if (joystick.buttons.at (j))
+                buttons |= 1u << j;
+        }
+
+        packet.append (static_cast<char> (4 + numAxes[i] + buttonBytes
+                                          + numPovs * 2));
+        packet.append (_JOYSTICK_TAG);
+
+        packet.append (static_cast<char> (numAxes[i]));
+        packet.append (reinterpret_cast<const char*> (axis), numAxes[i]);
+        axis += numAxes[i];
+
+        packet.append (static_cast<char> (numButtons));
+        for (int j = buttonBytes - 1; j >= 0; --j)
+            packet.append (static_cast<char> ((buttons >> (j * 8)) & 0xff));
+
+        packet.append (static_cast<char> (numPovs));
+        for (int j = 0; j < numPovs; ++j) {
+            qint16 angle = static_cast<qint16> (joystick.povs.at (j));
+            packet.append (static_cast<char> ((angle >> 8) & 0xff));
+            packet.append (static_cast<char> (angle & 0xff));
+        }
+    }
+
     return packet;
 }
 
-void DS_SendCommonControlPacket (DS_Status status,  DS_Alliance alliance,
-                                 DS_ControlMode mode, QString robotAddress)
+void DS_QuantizeAxes (const double* input, qint8* output, int count)
+{
+    int i = 0;
+
+#if defined __SSE2__
+    const __m128d lower = _mm_set1_pd (-1);
+    const __m128d upper = _mm_set1_pd (1);
+    const __m128d scale = _mm_set1_pd (127);
+
+    /* Convert four axes per iteration, NaN is masked to zero */
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd (input + i);
+        __m128d b = _mm_loadu_pd (input + i + 2);
+
+        a = _mm_and_pd (a, _mm_cmpord_pd (a, a));
+        b = _mm_and_pd (b, _mm_cmpord_pd (b, b));
+        a = _mm_mul_pd (_mm_min_pd (_mm_max_pd (a, lower), upper), scale);
+        b = _mm_mul_pd (_mm_min_pd (_mm_max_pd (b, lower), upper), scale);
+
+        __m128i words = _mm_unpacklo_epi64 (_mm_cvttpd_epi32 (a),
+                                            _mm_cvttpd_epi32 (b));
+        words = _mm_packs_epi32 (words, words);
+        words = _mm_packs_epi16 (words, words);
+
+        int bytes = _mm_cvtsi128_si32 (words);
+        memcpy (output + i, &bytes, 4);
+    }
+#endif
+
+    DS_QuantizeAxesScalar (input + i, output + i, count - i);
+}
+
+void DS_QuantizeAxesScalar (const double* input, qint8* output, int count)
+{
+    /* Branch-free so that the compiler can vectorize it on other targets */
+    for (int i = 0; i < count; ++i) {
+        double value = input[i] == input[i] ? input[i] : 0;
+        value = value < -1 ? -1 : value;
+        value = value > 1 ? 1 : value;
+        output[i] = static_cast<qint8> (value * 127);
+    }
+}
+
+/**
+ * Reads a big endian 32-bit value
+ */
+static quint32 readUInt32 (const uchar* data)
+{
+    return (static_cast<quint32> (data[0]) << 24)
+           | (static_cast<quint32> (data[1]) << 16)
+           | (static_cast<quint32> (data[2]) << 8)
+           | static_cast<quint32> (data[3]);
+}
+
+/**
+ * Reads a big endian IEEE 754 float
+ */
+static float readFloat (const uchar* data)
+{
+    float value;
+    quint32 bits = readUInt32 (data);
+    memcpy (&value, &bits, sizeof (value));
+    return value;
+}
+
+/**
+ * Disk section (0x04): total and free space, in bytes
+ */
+static int readDiskInfo (const uchar* data, int length, DS_State* state)
+{
+    if (length < 8)
+        return 0;
+
+    int total = static_cast<int> (readUInt32 (data) >> 20);
+    int used = total - static_cast<int> (readUInt32 (data + 4) >> 20);
+
+    if (state->diskTotal == total && state->diskUsed == used)
+        return 0;
+
+    state->diskTotal = total;
+    state->diskUsed = used;
+    return DS_DiskUsageField;
+}
+
+/**
+ * CPU section (0x05): number of CPUs, followed by four floats for each CPU
+ * with the time (%) spent in critical, above normal, normal and low priority
+ */
+static int readCpuInfo (const uchar* data, int length, DS_State* state)
+{
+    int count = length > 0 ? data[0] : 0;
+    if (count == 0 || length < 1 + count * 16)
+        return 0;
+
+    float total = 0;
+    for (int i = 0; i < count * 4; ++i)
+        total += readFloat (data + 1 + i * 4);
+
+    int usage = qBound (0, static_cast<int> (total / count), 100);
+    if (state->cpuUsage == usage)
+        return 0;
+
+    state->cpuUsage = usage;
+    return DS_CpuUsageField;
+}
+
+/**
+ * RAM section (0x06): total and free memory, in bytes
+ */
+static int readRamInfo (const uchar* data, int length, DS_State* state)
+{
+    if (length < 8)
+        return 0;
+
+    int total = static_cast<int> (readUInt32 (data) >> 20);
+    int used = total - static_cast<int> (readUInt32 (data + 4) >> 20);
+
+    if (state->ramTotal == total && state->ramUsed == used)
+        return 0;
+
+    state->ramTotal = total;
+    state->ramUsed = used;
+    return DS_RamUsageField;
+}
+
+/**
+ * PDP section (0x08): one unused byte, followed by the current of the 16
+ * channels as 10-bit values (in 1/8 A units) packed from the most
+ * significant bit, and three unused bytes
+ */
+static int readPdpInfo (const uchar* data, int length, DS_State* state)
 {
-    QPointer<QUdpSocket> socket = new QUdpSocket;
-    QByteArray packet = DS_CommonControlPacket (status, alliance, mode);
+    if (length < 22)
+        return 0;
+
+    float currents[16];
+    for (int i = 0; i < 16; ++i) {
+        int bit = i * 10;
+        int word = (data[1 + bit / 8] << 8) | data[2 + bit / 8];
+        currents[i] = ((word >> (6 - bit % 8)) & 0x3ff) / 8.0f;
+    }
+
+    if (memcmp (state->pdpCurrents, currents, sizeof (currents)) == 0)
+        return 0;
+
+    memcpy (state->pdpCurrents, currents, sizeof (currents));
+    return DS_PdpCurrentField;
+}
+
+/**
+ * CAN section (0x0e): bus utilization (%) as a float, followed by the bus
+ * off and TX full counters and the RX and TX error counters
+ */
+static int readCanInfo (const uchar* data, int length, DS_State* state)
+{
+    if (length < 4)
+        return 0;
+
+    float utilization = readFloat (data);
+    if (state->canUtilization == utilization)
+        return 0;
+
+    state->canUtilization = utilization;
+    return DS_CanUsageField;
+}
+
+/**
+ * Reads the data of an extended section into the state and returns the
+ * flags of the fields that changed
+ */
+typedef int (*TagReader) (const uchar* data, int length, DS_State* state);
+
+/**
+ * Readers of the extended sections, indexed by their tag. The table is
+ * built by the compiler, the tags without a reader are left empty
+ */
+static const TagReader tagReaders[256] = {
+    /* 0x00 */ nullptr, nullptr, nullptr, nullptr,
+    /* 0x04 */ readDiskInfo, readCpuInfo, readRamInfo, nullptr,
+    /* 0x08 */ readPdpInfo, nullptr, nullptr, nullptr,
+    /* 0x0c */ nullptr, nullptr, readCanInfo, nullptr
+};
+
+int DS_ReadRobotPacket (const QByteArray& packet, DS_State* state)
+{
+    int fields = 0;
+    int length = packet.size();
+    const uchar* data = reinterpret_cast<const uchar*> (packet.constData());
+
+    if (length < _ROBOT_HEADER_SIZE)
+        return 0;
+
+    float voltage = data[5] + data[6] / 256.0f;
+    if (state->voltage != voltage) {
+        state->voltage = voltage;
+        fields |= DS_VoltageField;
+    }
+
+    /* Stop at the first section that does not fit in the packet */
+    int offset = _ROBOT_HEADER_SIZE;
+    while (offset + 1 < length) {
+        int size = data[offset];
+        if (size == 0 || offset + 1 + size > length)
+            break;
+
+        TagReader reader = tagReaders[data[offset + 1]];
+        if (reader != nullptr)
+            fields |= reader (data + offset + 2, size - 1, state);
+
+        offset += 1 + size;
+    }
 
-    socket->writeDatagram (packet.data(), packet.size(),
-                           QHostAddress (robotAddress), 1150);
+    return fields;
 }
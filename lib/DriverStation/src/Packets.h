@@ -23,6 +23,8 @@
 #ifndef _DRIVER_STATION_CLIENT_PACKETS_H
 #define _DRIVER_STATION_CLIENT_PACKETS_H
 
+#include <QtGlobal>
+
 #include "Common.h"
 
 class QByteArray;
@@ -162,24 +164,57 @@ struct DS_RobotDataPacket {
 };
 
 /**
- * Generates a 6-byte packet that will be sent to the roboRIO at a rate of
+ * Generates the packet that will be sent to the roboRIO at a rate of
  * 50 Hz (20 times per second).
  *
  * The packet will contain:
- *     - Bytes 1 & 2: Ping data
+ *     - Bytes 1 & 2: Ping data (the \a index of the packet, big endian)
  *     - Byte 3: 0x01 (its magic)
  *     - Byte 4: Control mode (Autonomous, TeleOp, Test, etc)
  *     - Byte 5: Robot status (OK, RESTART_CODE or REBOOT)
  *     - Byte 6: Alliance and position of robot
+ *
+ * Followed by a joystick tag for each of the first six \a joysticks:
+ *     - Byte 1: Size of the tag (not counting this byte)
+ *     - Byte 2: 0x0c (the joystick tag)
+ *     - Axis count, followed by each axis as a signed byte
+ *     - Button count, followed by the buttons packed in big endian bytes
+ *     - POV count, followed by each POV angle as a big endian 16-bit value
+ */
+QByteArray DS_CommonControlPacket (quint16 index, DS_Status status,
+                                   DS_Alliance alliance, DS_ControlMode mode,
+                                   const QList<DS_JoystickData>& joysticks);
+
+/**
+ * Reads a packet sent by the roboRIO into the given \a state and returns
+ * the \c DS_StateField flags of the values that changed.
+ *
+ * The packet begins with an 8-byte header:
+ *     - Bytes 1 & 2: Ping data (the index of the answered control packet)
+ *     - Byte 3: 0x01 (its magic)
+ *     - Bytes 4 & 5: Control mode and robot status
+ *     - Bytes 6 & 7: Battery voltage (integer part and 1/256 units)
+ *     - Byte 8: Set if the robot requests the date
+ *
+ * Followed by the extended sections, each made of its size (not counting
+ * the size byte), a tag and its data. The sections are decoded with a
+ * table indexed by the tag, so unknown tags are skipped
+ */
+int DS_ReadRobotPacket (const QByteArray& packet, DS_State* state);
+
+/**
+ * Clamps the \a count axis values of \a input to the [-1, 1] range and
+ * scales them to signed bytes in \a output. NaN values are sent as 0.
+ *
+ * All the axes of all the joysticks are converted in a single batch, which
+ * is processed with SSE2 when the compiler supports it
  */
-QByteArray DS_CommonControlPacket (DS_Status status, DS_Alliance alliance,
-                                   DS_ControlMode mode);
+void DS_QuantizeAxes (const double* input, qint8* output, int count);
 
 /**
- * Sends a generated packet to the robot that contains the desired robot status,
- * its control mode, alliance and position.
+ * Portable version of \c DS_QuantizeAxes(), which converts the axes left
+ * after the SSE2 batches and is used to check that both versions agree
  */
-void DS_SendCommonControlPacket (DS_Status status, DS_Alliance alliance,
-                                 DS_ControlMode mode, QString robotAddress);
+void DS_QuantizeAxesScalar (const double* input, qint8* output, int count);
 
 #endif /* _DRIVER_STATION_CLIENT_PACKETS_H */
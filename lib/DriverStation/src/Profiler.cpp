@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QEvent>
+#include <QStringList>
+#include <QtAlgorithms>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+#include "Profiler.h"
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#if defined __gnu_linux__
+#include <fcntl.h>
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/* Milliseconds between each event loop probe */
+#define _PROBE_INTERVAL 250
+
+/* The process is sampled once every N probes */
+#define _SAMPLE_RATE 4
+
+/* Type of the events posted to measure the event loop latency */
+#define _PROBE_EVENT static_cast<QEvent::Type> (QEvent::User + 3794)
+
+DS_Profiler* DS_Profiler::m_instance = nullptr;
+
+DS_Profiler::DS_Profiler()
+{
+    m_probeTime = -1;
+    m_probeCount = 0;
+    m_lastCpuTime = -1;
+    m_lastSampleTime = 0;
+
+    m_process.cpuUsage = 0;
+    m_process.cpuTime = 0;
+    m_process.residentMemory = -1;
+    m_process.openFiles = -1;
+    m_process.loopLatency = 0;
+    m_process.maxLoopLatency = 0;
+
+    m_clock.start();
+}
+
+DS_Profiler* DS_Profiler::getInstance()
+{
+    if (m_instance == nullptr)
+        m_instance = new DS_Profiler();
+
+    return m_instance;
+}
+
+QList<DS_TimerStats> DS_Profiler::timerStats()
+{
+    QMutexLocker locker (&m_mutex);
+
+    QList<DS_TimerStats> list;
+    QStringList names = m_timers.keys();
+    qSort (names);
+
+    foreach (QString name, names)
+        list.append (m_timers.value (name));
+
+    return list;
+}
+
+DS_ProcessStats DS_Profiler::processStats()
+{
+    QMutexLocker locker (&m_mutex);
+    return m_process;
+}
+
+void DS_Profiler::init()
+{
+    probe();
+}
+
+void DS_Profiler::resetStats()
+{
+    QMutexLocker locker (&m_mutex);
+
+    QList<QString> names = m_timers.keys();
+    foreach (QString name, names) {
+        m_timers[name].count = 0;
+        m_timers[name].average = 0;
+        m_timers[name].maximum = 0;
+        m_totalLateness[name] = 0;
+    }
+
+    m_process.maxLoopLatency = 0;
+}
+
+void DS_Profiler::timerScheduled (const char* name, int msec)
+{
+    QMutexLocker locker (&m_mutex);
+
+    QString key = QString::fromLatin1 (name);
+    m_dueTimes.insert (key, m_clock.elapsed() + msec);
+
+    if (!m_timers.contains (key)) {
+        DS_TimerStats stats;
+        stats.name = key;
+        stats.count = 0;
+        stats.last = 0;
+        stats.average = 0;
+        stats.maximum = 0;
+
+        m_timers.insert (key, stats);
+        m_totalLateness.insert (key, 0);
+    }
+
+    m_timers[key].interval = msec;
+}
+
+void DS_Profiler::timerFired (const char* name)
+{
+    QMutexLocker locker (&m_mutex);
+
+    QString key = QString::fromLatin1 (name);
+    if (!m_dueTimes.contains (key))
+        return;
+
+    int lateness = qMax (0, static_cast<int> (m_clock.elapsed()
+                                             - m_dueTimes.take (key)));
+
+    DS_TimerStats& stats = m_timers[key];
+    stats.count += 1;
+    stats.last = lateness;
+    stats.maximum = qMax (stats.maximum, lateness);
+
+    m_totalLateness[key] += lateness;
+    stats.average = static_cast<int> (m_totalLateness[key] / stats.count);
+}
+
+void DS_Profiler::customEvent (QEvent* event)
+{
+    if (event->type() != _PROBE_EVENT || m_probeTime < 0)
+        return;
+
+    int latency = static_cast<int> (m_clock.elapsed() - m_probeTime);
+    m_probeTime = -1;
+
+    QMutexLocker locker (&m_mutex);
+    m_process.loopLatency = latency;
+    m_process.maxLoopLatency = qMax (m_process.maxLoopLatency, latency);
+}
+
+void DS_Profiler::probe()
+{
+    /* Only one probe is in flight, a stalled loop does not pile them up */
+    if (m_probeTime < 0) {
+        m_probeTime = m_clock.elapsed();
+        QCoreApplication::postEvent (this, new QEvent (_PROBE_EVENT),
+                                     Qt::LowEventPriority);
+    }
+
+    if (++m_probeCount >= _SAMPLE_RATE) {
+        m_probeCount = 0;
+        sampleProcess();
+    }
+
+    QTimer::singleShot (_PROBE_INTERVAL, this, SLOT (probe()));
+}
+
+void DS_Profiler::sampleProcess()
+{
+    qint64 cpuTime = 0;
+    qint64 residentMemory = -1;
+    int openFiles = -1;
+
+#if defined _WIN32 || defined _WIN64
+    FILETIME creation, exited, kernel, user;
+    HANDLE process = GetCurrentProcess();
+
+    /* FILETIME values are expressed in units of 100 nanoseconds */
+    if (GetProcessTimes (process, &creation, &exited, &kernel, &user)) {
+        ULARGE_INTEGER k, u;
+        k.LowPart = kernel.dwLowDateTime;
+        k.HighPart = kernel.dwHighDateTime;
+        u.LowPart = user.dwLowDateTime;
+        u.HighPart = user.dwHighDateTime;
+        cpuTime = static_cast<qint64> ((k.QuadPart + u.QuadPart) / 10000);
+    }
+
+    PROCESS_MEMORY_COUNTERS memory;
+    if (GetProcessMemoryInfo (process, &memory, sizeof (memory)))
+        residentMemory = static_cast<qint64> (memory.WorkingSetSize / 1024);
+
+    DWORD handles = 0;
+    if (GetProcessHandleCount (process, &handles))
+        openFiles = static_cast<int> (handles);
+#else
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) == 0) {
+        cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+                  + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    }
+#endif
+
+#if defined __gnu_linux__
+    /* The second field of statm is the number of resident pages */
+    static int statmFile = open ("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+
+    char buffer[128];
+    ssize_t length = pread (statmFile, buffer, sizeof (buffer) - 1, 0);
+    if (length > 0) {
+        char* cursor = buffer;
+        buffer[length] = 0;
+        strtoll (cursor, &cursor, 10);
+        residentMemory = strtoll (cursor, nullptr, 10)
+                         * (sysconf (_SC_PAGESIZE) / 1024);
+    }
+
+    /* Do not count the '.' and '..' entries and the directory itself */
+    DIR* directory = opendir ("/proc/self/fd");
+    if (directory != nullptr) {
+        openFiles = -3;
+        while (readdir (directory) != nullptr)
+            ++openFiles;
+
+        closedir (directory);
+    }
+#endif
+
+    qint64 now = m_clock.elapsed();
+
+    QMutexLocker locker (&m_mutex);
+
+    if (m_lastCpuTime >= 0 && now > m_lastSampleTime) {
+        m_process.cpuUsage = static_cast<int> ((cpuTime - m_lastCpuTime) * 100
+                                               / (now - m_lastSampleTime));
+    }
+
+    m_process.cpuTime = cpuTime;
+    m_process.openFiles = openFiles;
+    m_process.residentMemory = residentMemory;
+
+    m_lastCpuTime = cpuTime;
+    m_lastSampleTime = now;
+}
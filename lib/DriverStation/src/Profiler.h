@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_PROFILER_H
+#define _DRIVER_STATION_PROFILER_H
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+/**
+ * Holds the lateness statistics of a timer chain, all times are in
+ * milliseconds
+ */
+struct DS_TimerStats {
+    QString name;  /**< The name given to the timer chain */
+    int interval;  /**< The interval requested by the last schedule */
+    int count;     /**< The number of times that the timer fired */
+    int last;      /**< Lateness of the last shot */
+    int average;   /**< Average lateness of all the shots */
+    int maximum;   /**< Worst lateness since the last reset */
+};
+
+/**
+ * Holds the resource usage of the application process
+ */
+struct DS_ProcessStats {
+    int cpuUsage;          /**< CPU usage (% of one core) since last sample */
+    qint64 cpuTime;        /**< User and system CPU time in milliseconds */
+    qint64 residentMemory; /**< Resident set size in kilobytes, -1 if unknown */
+    int openFiles;         /**< Open file descriptors/handles, -1 if unknown */
+    int loopLatency;       /**< Last event loop latency in milliseconds */
+    int maxLoopLatency;    /**< Worst event loop latency since last reset */
+};
+
+/**
+ * \class DS_Profiler
+ *
+ * The DS_Profiler class measures the responsiveness of the application.
+ *
+ * Timer chains (a slot that re-schedules itself with \c QTimer::singleShot)
+ * report when they schedule their next shot and when that shot fires, which
+ * allows the profiler to calculate how late each shot was.
+ *
+ * The profiler also posts a probe event to the event loop of the thread in
+ * which it was created (the GUI thread) every 250 milliseconds to measure
+ * how long queued events wait before being delivered, and samples the CPU
+ * time, resident memory and open files of the process every second.
+ */
+class DS_Profiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Returns the only instance of the class
+     */
+    static DS_Profiler* getInstance();
+
+    /**
+     * Returns the statistics of every timer chain, sorted by name
+     */
+    QList<DS_TimerStats> timerStats();
+
+    /**
+     * Returns the last resource usage sample of the process
+     */
+    DS_ProcessStats processStats();
+
+public slots:
+    /**
+     * Begins measuring the event loop latency and the process usage
+     */
+    void init();
+
+    /**
+     * Clears the averages and the worst values measured so far
+     */
+    void resetStats();
+
+    /**
+     * Records that the timer chain called \a name will fire again in
+     * \a msec milliseconds. Can be called from any thread.
+     */
+    void timerScheduled (const char* name, int msec);
+
+    /**
+     * Records that the timer chain called \a name has fired. Should be called
+     * at the beginning of the slot invoked by the timer.
+     */
+    void timerFired (const char* name);
+
+protected:
+    explicit DS_Profiler();
+
+    /**
+     * Measures the latency of the probe events posted by the profiler
+     */
+    void customEvent (QEvent* event);
+
+private:
+    QMutex m_mutex;
+    QElapsedTimer m_clock;
+
+    qint64 m_probeTime;
+    int m_probeCount;
+    qint64 m_lastCpuTime;
+    qint64 m_lastSampleTime;
+
+    DS_ProcessStats m_process;
+    QHash<QString, qint64> m_dueTimes;
+    QHash<QString, qint64> m_totalLateness;
+    QHash<QString, DS_TimerStats> m_timers;
+
+    static DS_Profiler* m_instance;
+
+private slots:
+    /**
+     * @internal
+     * Posts a probe event and samples the process every fourth probe
+     */
+    void probe();
+
+    /**
+     * @internal
+     * Reads the CPU time, resident memory and open files of the process
+     */
+    void sampleProcess();
+};
+
+#endif /* _DRIVER_STATION_PROFILER_H */
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RateController.h"
+
+/* The 50 Hz rate used by the official Driver Station */
+#define _NOMINAL_INTERVAL 20
+
+/* Milliseconds added or removed from the interval by each decision */
+#define _INTERVAL_STEP 5
+
+/* The link is congested above these values */
+#define _CONGESTED_LOSS 5
+#define _CONGESTED_LATENCY 40
+
+/* The link is clean below this latency and without losses */
+#define _CLEAN_LATENCY 5
+
+/* Consecutive clean seconds needed to send more data */
+#define _CLEAN_WINDOWS 3
+
+/* Number of decisions kept in the log */
+#define _MAX_DECISIONS 1024
+
+DS_RateController::DS_RateController (QObject* parent) : QObject (parent)
+{
+    m_minInterval = 10;
+    m_maxInterval = _NOMINAL_INTERVAL;
+    m_interval = _NOMINAL_INTERVAL;
+    m_cleanWindows = 0;
+
+    m_clock.start();
+}
+
+int DS_RateController::interval()
+{
+    return m_interval;
+}
+
+QList<DS_RateDecision> DS_RateController::decisions()
+{
+    return m_decisions;
+}
+
+void DS_RateController::setBounds (int minInterval, int maxInterval)
+{
+    m_minInterval = qMax (minInterval, 1);
+    m_maxInterval = qMax (maxInterval, m_minInterval);
+    m_interval = qBound (m_minInterval, m_interval, m_maxInterval);
+
+    decide (tr ("Interval limited to %1-%2 ms").arg (m_minInterval)
+            .arg (m_maxInterval), -1, -1);
+}
+
+void DS_RateController::update (DS_LinkStats stats)
+{
+    /* Do not adapt without a measurement */
+    if (stats.latency < 0) {
+        m_cleanWindows = 0;
+        return;
+    }
+
+    bool congested = stats.lossRate > _CONGESTED_LOSS
+                     || stats.latency > _CONGESTED_LATENCY;
+    bool clean = stats.lossRate == 0 && stats.latency <= _CLEAN_LATENCY;
+
+    if (congested) {
+        m_cleanWindows = 0;
+
+        if (m_interval < m_maxInterval) {
+            m_interval = qMin (m_interval + _INTERVAL_STEP, m_maxInterval);
+            decide (tr ("Link congested, sending fewer packets"),
+                    stats.lossRate, stats.latency);
+        }
+    }
+
+    else if (clean && ++m_cleanWindows >= _CLEAN_WINDOWS) {
+        m_cleanWindows = 0;
+
+        if (m_interval > m_minInterval) {
+            m_interval = qMax (m_interval - _INTERVAL_STEP, m_minInterval);
+            decide (tr ("Link clean, sending more packets"),
+                    stats.lossRate, stats.latency);
+        }
+    }
+
+    else if (!clean) {
+        m_cleanWindows = 0;
+    }
+}
+
+void DS_RateController::decide (QString reason, int lossRate, int latency)
+{
+    DS_RateDecision decision;
+    decision.time = m_clock.elapsed();
+    decision.interval = m_interval;
+    decision.lossRate = lossRate;
+    decision.latency = latency;
+    decision.reason = reason;
+
+    m_decisions.append (decision);
+    if (m_decisions.count() > _MAX_DECISIONS)
+        m_decisions.removeFirst();
+
+    emit decisionMade (decision);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_RATE_CONTROLLER_H
+#define _DRIVER_STATION_RATE_CONTROLLER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+#include "RobotLink.h"
+
+/**
+ * Represents a change made by the \c DS_RateController and the link
+ * conditions that caused it
+ */
+struct DS_RateDecision {
+    qint64 time;    /**< Milliseconds since the DS started */
+    int interval;   /**< Milliseconds between each control packet */
+    int lossRate;   /**< Packet loss (%) measured in the last second */
+    int latency;    /**< Round trip time (ms) measured in the last second */
+    QString reason; /**< User-friendly explanation of the decision */
+};
+
+/**
+ * \class DS_RateController
+ *
+ * The DS_RateController class decides how often the control packets are
+ * sent to the robot, based on the packet loss and round trip time measured
+ * by the \c DS_RobotLink.
+ *
+ * Every control packet carries the complete state of the joysticks, since
+ * a packet without joystick data means that no joysticks are attached, so
+ * the packet interval is the only thing that the controller adapts. When
+ * the link is congested, the packets are sent less often, but never less
+ * often than the configured maximum interval, so that the control mode,
+ * status and joysticks of the robot are always refreshed in time. When the
+ * link has been clean for a few seconds, the controller does the opposite,
+ * down to the configured minimum interval.
+ *
+ * Every decision is kept in a bounded log and announced with the
+ * \c decisionMade() signal, so it can be analyzed after a match.
+ */
+class DS_RateController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DS_RateController (QObject* parent = 0);
+
+    /**
+     * Returns the milliseconds to wait before sending the next packet
+     */
+    int interval();
+
+    /**
+     * Returns the recent decisions of the controller, oldest first
+     */
+    QList<DS_RateDecision> decisions();
+
+public slots:
+    /**
+     * Changes the minimum and maximum milliseconds between each packet
+     */
+    void setBounds (int minInterval, int maxInterval);
+
+    /**
+     * Adapts the packet rate to the link \a stats of the last second
+     */
+    void update (DS_LinkStats stats);
+
+signals:
+    /**
+     * Emitted when the packet interval changes
+     */
+    void decisionMade (DS_RateDecision decision);
+
+private:
+    /**
+     * @internal
+     * Logs the current settings with the given \a reason
+     */
+    void decide (QString reason, int lossRate, int latency);
+
+    int m_interval;
+    int m_minInterval;
+    int m_maxInterval;
+    int m_cleanWindows;
+
+    QElapsedTimer m_clock;
+    QList<DS_RateDecision> m_decisions;
+};
+
+#endif /* _DRIVER_STATION_RATE_CONTROLLER_H */
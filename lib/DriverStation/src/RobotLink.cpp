@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QMutexLocker>
+
+#include "Packets.h"
+#include "RobotLink.h"
+
+#define _NET_ROBORIO_PORT 1110
+#define _NET_DRIVER_STATION_PORT 1150
+
+/* A packet that is not answered within this time is considered lost */
+#define _REPLY_TIMEOUT 1000
+
+/* Milliseconds between each update of the loss and latency counters */
+#define _STATS_INTERVAL 1000
+
+DS_RobotLink::DS_RobotLink (QObject* parent) : QObject (parent)
+{
+    m_index = 0;
+    m_firstPacketSent = false;
+    m_windowSent = 0;
+    m_windowLost = 0;
+    m_windowReplies = 0;
+    m_windowLatency = 0;
+    m_windowMaxLatency = 0;
+
+    m_stats.sent = 0;
+    m_stats.received = 0;
+    m_stats.lost = 0;
+    m_stats.lossRate = 0;
+    m_stats.latency = -1;
+    m_stats.maxLatency = -1;
+
+    for (int i = 0; i < 256; ++i)
+        m_history[i].pending = false;
+
+    m_inSocket = new QUdpSocket (this);
+    m_outSocket = new QUdpSocket (this);
+    m_clock.start();
+
+    connect (m_inSocket, SIGNAL (readyRead()), this, SLOT (onPacketReceived()));
+}
+
+DS_LinkStats DS_RobotLink::stats()
+{
+    QMutexLocker locker (&m_mutex);
+    return m_stats;
+}
+
+void DS_RobotLink::init()
+{
+    m_inSocket->bind (_NET_DRIVER_STATION_PORT, QUdpSocket::ShareAddress);
+    updateStats();
+}
+
+void DS_RobotLink::sendControlPacket (DS_Status status, DS_Alliance alliance,
+                                      DS_ControlMode mode, QString address,
+                                      const QList<DS_JoystickData>& joysticks)
+{
+    ++m_index;
+    QByteArray packet = DS_CommonControlPacket (m_index, status, alliance,
+                                                mode, joysticks);
+
+    qint64 written = m_outSocket->writeDatagram (packet,
+                                                 QHostAddress (address),
+                                                 _NET_ROBORIO_PORT);
+
+    /* Remember when the packet was sent to measure its round trip time */
+    QMutexLocker locker (&m_mutex);
+    SentPacket& sent = m_history[m_index % 256];
+    if (sent.pending)
+        ++m_windowLost;
+
+    sent.index = m_index;
+    sent.time = m_clock.elapsed();
+    sent.pending = true;
+
+    ++m_windowSent;
+    ++m_stats.sent;
+    locker.unlock();
+
+    if (!m_firstPacketSent && written == packet.size()) {
+        m_firstPacketSent = true;
+        emit firstPacketSent();
+    }
+}
+
+void DS_RobotLink::onPacketReceived()
+{
+    while (m_inSocket->hasPendingDatagrams()) {
+        QByteArray packet;
+        packet.resize (m_inSocket->pendingDatagramSize());
+        m_inSocket->readDatagram (packet.data(), packet.size());
+
+        if (packet.size() < 2)
+            continue;
+
+        /* The first two bytes echo the sequence number of our packet */
+        quint16 index = (static_cast<quint8> (packet.at (0)) << 8)
+                        | static_cast<quint8> (packet.at (1));
+
+        m_mutex.lock();
+        ++m_stats.received;
+
+        SentPacket& sent = m_history[index % 256];
+        if (sent.pending && sent.index == index) {
+            int latency = static_cast<int> (m_clock.elapsed() - sent.time);
+            sent.pending = false;
+
+            ++m_windowReplies;
+            m_windowLatency += latency;
+            m_windowMaxLatency = qMax (m_windowMaxLatency, latency);
+        }
+
+        m_mutex.unlock();
+
+        emit packetReceived (packet);
+    }
+}
+
+void DS_RobotLink::updateStats()
+{
+    m_mutex.lock();
+    qint64 now = m_clock.elapsed();
+
+    /* Give up on the packets that were not answered in time */
+    for (int i = 0; i < 256; ++i) {
+        if (m_history[i].pending && now - m_history[i].time > _REPLY_TIMEOUT) {
+            m_history[i].pending = false;
+            ++m_windowLost;
+        }
+    }
+
+    m_stats.lost += m_windowLost;
+    m_stats.lossRate = m_windowSent > 0 ?
+                       qMin (100, m_windowLost * 100 / m_windowSent) : 0;
+    m_stats.latency = m_windowReplies > 0 ?
+                      static_cast<int> (m_windowLatency / m_windowReplies) : -1;
+    m_stats.maxLatency = m_windowReplies > 0 ? m_windowMaxLatency : -1;
+
+    m_windowSent = 0;
+    m_windowLost = 0;
+    m_windowReplies = 0;
+    m_windowLatency = 0;
+    m_windowMaxLatency = 0;
+
+    DS_LinkStats stats = m_stats;
+    m_mutex.unlock();
+
+    emit statsChanged (stats);
+    QTimer::singleShot (_STATS_INTERVAL, this, SLOT (updateStats()));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_ROBOT_LINK_H
+#define _DRIVER_STATION_ROBOT_LINK_H
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+#include "Common.h"
+
+class QUdpSocket;
+
+/**
+ * Holds the packet loss and latency counters of the link with the robot
+ */
+struct DS_LinkStats {
+    quint32 sent;     /**< Control packets sent since the DS started */
+    quint32 received; /**< Robot packets received since the DS started */
+    quint32 lost;     /**< Control packets that were never answered */
+    int lossRate;     /**< Percentage of packets lost in the last second */
+    int latency;      /**< Average round trip time (ms) in the last second */
+    int maxLatency;   /**< Worst round trip time (ms) in the last second */
+};
+
+/**
+ * \class DS_RobotLink
+ *
+ * The DS_RobotLink class sends the control packets to the roboRIO and
+ * receives the packets that the roboRIO sends back.
+ *
+ * Each control packet carries a sequence number, which the roboRIO echoes
+ * in its reply. This allows the class to calculate the round trip time of
+ * each packet and to count the packets that were never answered.
+ */
+class DS_RobotLink : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DS_RobotLink (QObject* parent = 0);
+
+    /**
+     * Returns the current counters of the link. Can be called from any thread.
+     */
+    DS_LinkStats stats();
+
+public slots:
+    /**
+     * Binds the input socket and begins updating the counters every second
+     */
+    void init();
+
+    /**
+     * Generates a control packet with the next sequence number and the state
+     * of the \a joysticks and sends it to the roboRIO in the given \a address
+     */
+    void sendControlPacket (DS_Status status, DS_Alliance alliance,
+                            DS_ControlMode mode, QString address,
+                            const QList<DS_JoystickData>& joysticks);
+
+signals:
+    /**
+     * Emitted when a packet is received from the roboRIO
+     */
+    void packetReceived (QByteArray packet);
+
+    /**
+     * Emitted once, when the first control packet is written to the socket
+     */
+    void firstPacketSent();
+
+    /**
+     * Emitted every second with the updated counters of the link
+     */
+    void statsChanged (DS_LinkStats stats);
+
+private:
+    /**
+     * Remembers when a sequence number was sent, and if it was answered
+     */
+    struct SentPacket {
+        quint16 index;
+        qint64 time;
+        bool pending;
+    };
+
+    QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QUdpSocket* m_inSocket;
+    QUdpSocket* m_outSocket;
+
+    quint16 m_index;
+    bool m_firstPacketSent;
+    SentPacket m_history[256];
+    DS_LinkStats m_stats;
+
+    int m_windowSent;
+    int m_windowLost;
+    int m_windowReplies;
+    qint64 m_windowLatency;
+    int m_windowMaxLatency;
+
+private slots:
+    /**
+     * @internal
+     * Reads the packets sent by the roboRIO and measures their round trip
+     */
+    void onPacketReceived();
+
+    /**
+     * @internal
+     * Counts the packets that were not answered in time and calculates the
+     * loss rate and latency of the last second
+     */
+    void updateStats();
+};
+
+#endif /* _DRIVER_STATION_ROBOT_LINK_H */
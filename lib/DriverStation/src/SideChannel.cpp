@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QTcpSocket>
+
+#include "SideChannel.h"
+
+#define _NET_ROBORIO_TCP_PORT 1740
+
+/* Changes made within this time are written together */
+#define _COALESCE_DELAY 50
+
+/* Milliseconds between each connection attempt */
+#define _RECONNECT_INTERVAL 1000
+
+/* Tags that identify the data of each frame */
+#define _TAG_JOYSTICK_DESCRIPTOR 0x02
+#define _TAG_MATCH_INFO 0x07
+#define _TAG_GAME_DATA 0x0e
+
+/* Only the first six joysticks are sent to the robot */
+#define _MAX_JOYSTICKS 6
+
+DS_SideChannel::DS_SideChannel (QObject* parent) : QObject (parent)
+{
+    m_bytesSent = 0;
+    m_flushPending = false;
+    m_socket = new QTcpSocket (this);
+
+    connect (m_socket, SIGNAL (connected()),
+             this,       SLOT (onConnected()));
+    connect (m_socket, SIGNAL (disconnected()),
+             this,       SLOT (onDisconnected()));
+    connect (m_socket, SIGNAL (error (QAbstractSocket::SocketError)),
+             this,       SLOT (onDisconnected()));
+    connect (m_socket, SIGNAL (readyRead()),
+             this,       SLOT (onReadyRead()));
+}
+
+bool DS_SideChannel::isConnected()
+{
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+qint64 DS_SideChannel::bytesSent()
+{
+    return m_bytesSent;
+}
+
+void DS_SideChannel::setAddress (QString address)
+{
+    if (m_address == address)
+        return;
+
+    m_address = address;
+    m_socket->abort();
+    reconnect();
+}
+
+void DS_SideChannel::setJoystickDescriptors (QList<DS_JoystickDescriptor>
+                                             joysticks)
+{
+    for (int i = 0; i < _MAX_JOYSTICKS; ++i) {
+        int key = (_TAG_JOYSTICK_DESCRIPTOR << 8) | i;
+
+        /* Nothing to tell the robot about a slot that was never used */
+        if (i >= joysticks.count() && !m_frames.contains (key))
+            continue;
+
+        DS_JoystickDescriptor joystick;
+        joystick.numAxes = 0;
+        joystick.numButtons = 0;
+        joystick.numPovs = 0;
+
+        if (i < joysticks.count())
+            joystick = joysticks.at (i);
+
+        QByteArray name = joystick.name.toUtf8().left (255);
+        int numAxes = qBound (0, joystick.numAxes, 255);
+
+        QByteArray data;
+        data.append (static_cast<char> (i));
+        data.append (static_cast<char> (0));
+        data.append (static_cast<char> (0));
+        data.append (static_cast<char> (name.length()));
+        data.append (name);
+        data.append (static_cast<char> (numAxes));
+        data.append (QByteArray (numAxes, 0));
+        data.append (static_cast<char> (qBound (0, joystick.numButtons, 255)));
+        data.append (static_cast<char> (qBound (0, joystick.numPovs, 255)));
+
+        put (key, _TAG_JOYSTICK_DESCRIPTOR, data);
+    }
+}
+
+void DS_SideChannel::setGameData (QString data)
+{
+    put (_TAG_GAME_DATA << 8, _TAG_GAME_DATA, data.toUtf8());
+}
+
+void DS_SideChannel::setMatchInfo (DS_MatchInfo info)
+{
+    QByteArray name = info.eventName.toUtf8().left (255);
+
+    QByteArray data;
+    data.append (static_cast<char> (name.length()));
+    data.append (name);
+    data.append (static_cast<char> (info.type));
+    data.append (static_cast<char> ((info.number >> 8) & 0xff));
+    data.append (static_cast<char> (info.number & 0xff));
+    data.append (static_cast<char> (info.replay));
+
+    put (_TAG_MATCH_INFO << 8, _TAG_MATCH_INFO, data);
+}
+
+void DS_SideChannel::put (int key, int tag, const QByteArray& data)
+{
+    QByteArray frame;
+    int size = qMin (data.length() + 1, 0xffff);
+    frame.append (static_cast<char> ((size >> 8) & 0xff));
+    frame.append (static_cast<char> (size & 0xff));
+    frame.append (static_cast<char> (tag));
+    frame.append (data.left (size - 1));
+
+    /* The robot already knows this value */
+    if (m_frames.value (key) == frame)
+        return;
+
+    m_frames.insert (key, frame);
+    if (!m_changed.contains (key))
+        m_changed.append (key);
+
+    scheduleFlush();
+}
+
+void DS_SideChannel::scheduleFlush()
+{
+    if (!m_flushPending) {
+        m_flushPending = true;
+        QTimer::singleShot (_COALESCE_DELAY, this, SLOT (flush()));
+    }
+}
+
+void DS_SideChannel::flush()
+{
+    m_flushPending = false;
+
+    /* The frames are kept and sent when the connection is established */
+    if (!isConnected())
+        return;
+
+    QByteArray buffer;
+    foreach (int key, m_changed)
+        buffer.append (m_frames.value (key));
+
+    m_changed.clear();
+
+    if (!buffer.isEmpty())
+        m_bytesSent += m_socket->write (buffer);
+}
+
+void DS_SideChannel::reconnect()
+{
+    if (!m_address.isEmpty()
+            && m_socket->state() == QAbstractSocket::UnconnectedState)
+        m_socket->connectToHost (m_address, _NET_ROBORIO_TCP_PORT);
+}
+
+void DS_SideChannel::onConnected()
+{
+    m_changed = m_frames.keys();
+    flush();
+}
+
+void DS_SideChannel::onDisconnected()
+{
+    if (!m_address.isEmpty())
+        QTimer::singleShot (_RECONNECT_INTERVAL, this, SLOT (reconnect()));
+}
+
+void DS_SideChannel::onReadyRead()
+{
+    m_socket->readAll();
+}
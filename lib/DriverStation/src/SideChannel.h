@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _DRIVER_STATION_SIDE_CHANNEL_H
+#define _DRIVER_STATION_SIDE_CHANNEL_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+#include "Common.h"
+
+class QTcpSocket;
+
+/**
+ * \class DS_SideChannel
+ *
+ * The DS_SideChannel class sends the data that rarely changes (such as the
+ * joystick descriptors, the game data and the match information) to the
+ * roboRIO through a TCP connection, so that it does not need to be repeated
+ * in each of the control packets that are sent 50 times per second.
+ *
+ * Each value is sent as a frame made of its size (two bytes, big endian),
+ * a tag and its data. A frame is only sent if it is different from the last
+ * frame sent for the same value, and the changes made in a short period of
+ * time are written together. When the connection is established again,
+ * the last frame of each value is sent again.
+ */
+class DS_SideChannel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DS_SideChannel (QObject* parent = 0);
+
+    /**
+     * Returns \c true if the channel is connected to the roboRIO
+     */
+    bool isConnected();
+
+    /**
+     * Returns the number of bytes written since the DS started
+     */
+    qint64 bytesSent();
+
+public slots:
+    /**
+     * Connects to the roboRIO in the given \a address, an empty address
+     * closes the connection
+     */
+    void setAddress (QString address);
+
+    /**
+     * Sends the descriptors of the first six \a joysticks, the descriptors
+     * of the removed joysticks are sent as empty descriptors
+     */
+    void setJoystickDescriptors (QList<DS_JoystickDescriptor> joysticks);
+
+    /**
+     * Sends the game-specific message given by the field management system
+     */
+    void setGameData (QString data);
+
+    /**
+     * Sends the information of the current match
+     */
+    void setMatchInfo (DS_MatchInfo info);
+
+private:
+    /**
+     * @internal
+     * Builds the frame of the value identified by \a key with the given
+     * \a tag and \a data, and schedules its write if it changed
+     */
+    void put (int key, int tag, const QByteArray& data);
+
+    /**
+     * @internal
+     * Schedules the write of the changed frames
+     */
+    void scheduleFlush();
+
+    bool m_flushPending;
+    qint64 m_bytesSent;
+    QString m_address;
+    QTcpSocket* m_socket;
+    QList<int> m_changed;
+    QMap<int, QByteArray> m_frames;
+
+private slots:
+    /**
+     * @internal
+     * Writes the changed frames in a single operation
+     */
+    void flush();
+
+    /**
+     * @internal
+     * Tries to connect to the roboRIO again
+     */
+    void reconnect();
+
+    /**
+     * @internal
+     * Sends the last frame of each value when the connection is established
+     */
+    void onConnected();
+
+    /**
+     * @internal
+     * Schedules a new connection attempt
+     */
+    void onDisconnected();
+
+    /**
+     * @internal
+     * Discards the data sent by the roboRIO, which is not used yet
+     */
+    void onReadyRead();
+};
+
+#endif /* _DRIVER_STATION_SIDE_CHANNEL_H */
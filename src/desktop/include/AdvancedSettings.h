@@ -65,6 +65,13 @@ public:
      */
     void setTeamNumber (int team);
 
+    /**
+     * Changes the palette of the application based on current settings.
+     * Called before the main window is created, so that the dialog itself
+     * does not need to be created during startup
+     */
+    static void loadApplicationColors();
+
 signals:
     void settingsChanged();
 
@@ -93,12 +100,6 @@ private slots:
      */
     void resetSettings();
 
-    /**
-     * @internal
-     * Changes the palette of the application based on current settings
-     */
-    void loadApplicationColors();
-
     /**
      * @internal
      * Clears the settings and re-loads them
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_AXIS_CONDITIONER_H
+#define _QDS_AXIS_CONDITIONER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * Represents the conditioning settings of a joystick axis
+ */
+struct AC_Config {
+    double deadzone; /**< Part of the travel around the center that reads 0 */
+    double expo;     /**< Blend between a linear (0) and a cubic (1) curve */
+    bool inverted;   /**< If \c true, the direction of the axis is inverted */
+    double minimum;  /**< Raw value read at the lower end of the travel */
+    double center;   /**< Raw value read when the axis is released */
+    double maximum;  /**< Raw value read at the upper end of the travel */
+};
+
+/**
+ * @class AxisConditioner
+ * @brief Applies the calibration, deadzone and expo settings of a joystick
+ *
+ * The \c AxisConditioner converts the raw axis values (between -1 and 1) of
+ * a joystick into the values that are shown to the user and sent to the
+ * robot. For each axis, the raw value is calibrated, inverted, passed
+ * through the deadzone and shaped by the expo curve.
+ *
+ * The settings are stored per controller GUID, so they follow the device
+ * even if it is plugged into another USB port. They are kept in plain
+ * arrays (one per setting) and all the axes of the joystick are converted
+ * in a single pass without branches, which the compiler can vectorize.
+ *
+ * Finally, a conditioned value is only reported if it moved more than the
+ * hysteresis threshold since the last reported value, so that the noise
+ * of a released stick does not generate a constant stream of updates.
+ */
+class AxisConditioner
+{
+public:
+    explicit AxisConditioner();
+
+    /**
+     * Loads the saved settings of the joystick with the given \a guid and
+     * the given number of \a axes
+     */
+    void load (QString guid, int axes);
+
+    /**
+     * Returns the settings of the given \a axis
+     */
+    AC_Config config (int axis) const;
+
+    /**
+     * Changes and saves the settings of the given \a axis
+     */
+    void setConfig (int axis, AC_Config config);
+
+    /**
+     * Returns the minimum change needed to report a new axis value
+     */
+    double hysteresis() const;
+
+    /**
+     * Changes and saves the minimum change needed to report a new value
+     */
+    void setHysteresis (double hysteresis);
+
+    /**
+     * Conditions the \a count raw values of \a input and writes them to
+     * \a output. Returns \c true if any of the reported values changed
+     */
+    bool process (const double* input, double* output, int count);
+
+    /**
+     * Returns the default settings of an axis
+     */
+    static AC_Config defaultConfig();
+
+private:
+    /**
+     * @internal
+     * Calculates the coefficients used by \c process() for the given \a axis
+     */
+    void updateCoefficients (int axis);
+
+    /**
+     * @internal
+     * Returns the settings key of the given \a axis and \a name
+     */
+    QString key (int axis, QString name) const;
+
+    QString m_guid;
+    double m_hysteresis;
+    QVector<AC_Config> m_configs;
+
+    QVector<double> m_center;
+    QVector<double> m_lowScale;
+    QVector<double> m_highScale;
+    QVector<double> m_deadzone;
+    QVector<double> m_deadScale;
+    QVector<double> m_expo;
+    QVector<double> m_last;
+};
+
+#endif /* _QDS_AXIS_CONDITIONER_H */
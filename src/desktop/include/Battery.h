@@ -36,14 +36,40 @@
 class Battery
 {
 public:
+    /**
+     * Holds the values read from the power supplies of the host computer
+     * during a single sample.
+     */
+    struct Status {
+        bool plugged;      /**< \c true if an AC power supply is connected */
+        bool discharging;  /**< \c true if the batteries are discharging */
+        int level;         /**< Battery level, between 0 and 100 */
+        int power;         /**< Power draw in milliwatts, -1 if unknown */
+        int timeToEmpty;   /**< Minutes until empty, -1 if unknown */
+    };
+
+    /**
+     * Obtains the AC line status, battery level, power draw and remaining
+     * time of the host computer in a single pass.
+     *
+     * On Linux, the \c uevent files of the power supplies found in
+     * \c /sys/class/power_supply are kept open and re-read on each call,
+     * which is cheap enough to be done every second. If the computer has
+     * more than one battery, their values are combined.
+     *
+     * On Windows, the power draw is not reported. On Mac, only the AC line
+     * status and the battery level are reported.
+     */
+    static Status readStatus();
+
     /**
      * Uses native API calls for the target operating system to obtain the
      * status of the AC line power. Used to display the 'plug' icon near the
      * battery progress bar in the MainWindow.
      *
-     * If the target operating system is Mac or Linux, reads the output of a
-     * command line utility to determine if the computer is connected to
-     * an AC power supply.
+     * If the target operating system is Mac, reads the output of a command
+     * line utility to determine if the computer is connected to an AC
+     * power supply.
      *
      * @return \c true if the computer is connected to an AC power supply
      */
@@ -54,8 +80,8 @@ public:
      * current battery percentage. Used to display the current level of the
      * battery in the MainWindow.
      *
-     * If the target operating system is Mac or Linux, reads the output of a
-     * command line utility to determine the battery level of the laptop.
+     * If the target operating system is Mac, reads the output of a command
+     * line utility to determine the battery level of the laptop.
      *
      * @return an \c int between 0 and 100 that represents the battery level
      */
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_CHART_SERIES_H
+#define _QDS_CHART_SERIES_H
+
+#include <QVector>
+
+/**
+ * Represents the lowest and highest values measured during a period of time
+ */
+struct CS_Point {
+    qint64 time; /**< The time (in milliseconds) of the first value */
+    float min;   /**< The lowest value of the period */
+    float max;   /**< The highest value of the period */
+};
+
+/**
+ * @class ChartSeries
+ * @brief Keeps the recent history of a value with a bounded amount of memory
+ *
+ * The \c ChartSeries stores every new value in a ring buffer and, at the
+ * same time, in coarser ring buffers where each point holds the lowest and
+ * highest value of 8, 64, 512... consecutive values. Each ring buffer has
+ * the same capacity, so the memory used by the series never grows.
+ *
+ * When a chart asks for a period of time, the series reads the finest ring
+ * buffer that still covers that period. Since every point keeps its minimum
+ * and maximum, spikes are never lost, and the number of points that need to
+ * be read does not depend on the length of the period.
+ */
+class ChartSeries
+{
+public:
+    explicit ChartSeries();
+
+    /**
+     * Returns \c true if no values have been added to the series
+     */
+    bool isEmpty() const;
+
+    /**
+     * Returns the last value added to the series
+     */
+    float lastValue() const;
+
+    /**
+     * Adds a new \a value measured at the given \a time (in milliseconds).
+     * The times must be given in ascending order
+     */
+    void append (qint64 time, float value);
+
+    /**
+     * Removes all the values of the series
+     */
+    void clear();
+
+    /**
+     * Divides the period between \a from and \a to in the given number of
+     * \a columns and returns the minimum and maximum values of each column.
+     * Columns without values are not included in the returned list
+     */
+    QVector<CS_Point> points (qint64 from, qint64 to, int columns) const;
+
+private:
+    /**
+     * Represents one of the ring buffers of the series
+     */
+    struct Level {
+        int head;                /**< Index of the next point to write */
+        int count;               /**< Number of valid points in the ring */
+        int pendingCount;        /**< Values merged into \c pending */
+        CS_Point pending;        /**< The point that is being built */
+        QVector<CS_Point> ring;  /**< The finished points */
+    };
+
+    QVector<Level> m_levels;
+
+    /**
+     * @internal
+     * Writes the \a point in the ring buffer of the given \a level and
+     * merges it into the pending point of the next level
+     */
+    void push (int level, const CS_Point& point);
+
+    /**
+     * @internal
+     * Returns the index of the finest level that holds the values
+     * measured at the given \a time
+     */
+    int levelFor (qint64 time) const;
+};
+
+#endif /* _QDS_CHART_SERIES_H */
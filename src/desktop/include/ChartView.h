@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_CHART_VIEW_H
+#define _QDS_CHART_VIEW_H
+
+#include <QColor>
+#include <QWidget>
+
+#include "TelemetryStore.h"
+
+class ChartSeries;
+
+/**
+ * @class ChartView
+ * @brief Draws the recent history of a \c ChartSeries
+ *
+ * The \c ChartView asks its series for one minimum/maximum pair per pixel
+ * column and draws a vertical line for each column, so the cost of painting
+ * the chart depends on its width and not on the length of the period shown.
+ *
+ * When the whole session is shown, the points are read from the compressed
+ * blocks of the \c TelemetryStore instead.
+ */
+class ChartView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ChartView (const QString& title,
+                        const QString& units,
+                        const QColor& color,
+                        TS_Channel channel,
+                        ChartSeries* series,
+                        QWidget* parent = 0);
+
+    QSize sizeHint() const;
+
+    /**
+     * Changes the fixed range of the vertical axis. If \a maximum is not
+     * greater than \a minimum, the range is calculated from the values shown
+     */
+    void setRange (float minimum, float maximum);
+
+public slots:
+    /**
+     * Changes the period (in milliseconds) shown by the chart, the period
+     * ends at the given \a now time. If \a window is \c 0, the chart shows
+     * the whole session
+     */
+    void setWindow (qint64 now, qint64 window);
+
+protected:
+    void paintEvent (QPaintEvent* event);
+
+private:
+    QColor m_color;
+    QString m_title;
+    QString m_units;
+
+    float m_minimum;
+    float m_maximum;
+
+    qint64 m_now;
+    qint64 m_window;
+
+    TS_Channel m_channel;
+    ChartSeries* m_series;
+};
+
+#endif /* _QDS_CHART_VIEW_H */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_CHARTS_H
+#define _QDS_CHARTS_H
+
+#include <QWidget>
+
+#include "ChartSeries.h"
+#include "TelemetryStore.h"
+
+class QTimer;
+class QComboBox;
+class ChartView;
+
+/**
+ * @class Charts
+ * @brief Shows the recent history of the robot and computer measurements
+ *
+ * The \c Charts widget copies the values recorded by the \c TelemetryStore
+ * (voltage, packet loss, round trip time and CPU usage) to \c ChartSeries
+ * objects, and draws them in the "Charts" tab of the \c MainWindow.
+ *
+ * The values are recorded all the time, but the charts are only repainted
+ * while the widget is visible.
+ */
+class Charts : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Charts (QWidget* parent = 0);
+
+protected:
+    /**
+     * @internal
+     * Begins repainting the charts when the widget is shown
+     */
+    void showEvent (QShowEvent* event);
+
+    /**
+     * @internal
+     * Stops repainting the charts when the widget is hidden
+     */
+    void hideEvent (QHideEvent* event);
+
+private:
+    QTimer* m_timer;
+    QComboBox* m_windowCombo;
+
+    QList<ChartView*> m_views;
+    ChartSeries m_series[TS_ChannelCount];
+
+private slots:
+    /**
+     * @internal
+     * Moves the charts to the current time and repaints them
+     */
+    void refresh();
+
+    /**
+     * @internal
+     * Saves the period selected by the user and repaints the charts
+     */
+    void onWindowChanged (int index);
+
+    /**
+     * @internal
+     * Asks the user for a file and exports the telemetry of the session
+     * from a background thread
+     */
+    void onExportClicked();
+
+    /**
+     * @internal
+     * Reports the result of the telemetry export in the NetConsole
+     */
+    void onExportFinished (bool success, QString path);
+
+    /**
+     * @internal
+     * Copies a new value of the \c TelemetryStore to its chart series
+     */
+    void onSampleAdded (int channel, qint64 time, float value);
+};
+
+#endif /* _QDS_CHARTS_H */
@@ -23,6 +23,8 @@
 #ifndef _QDS_CPU_USAGE_H
 #define _QDS_CPU_USAGE_H
 
+#include <QList>
+
 /**
  * @class CpuUsage
  * @brief Provides information about the CPU usage of the host computer
@@ -46,12 +48,25 @@ public:
      * Uses the native API calls of the target operating system to obtain the
      * current CPU usage levels.
      *
-     * If the target operating system is Mac or Linux, reads the output of a
-     * command line utility to determine the CPU usage level.
+     * On Linux, reads the counters in \c /proc/stat and compares them with
+     * the counters of the previous call, so the returned value is the usage
+     * since the last call (and not since boot). The first call returns 0.
+     *
+     * If the target operating system is Mac, reads the output of a command
+     * line utility to determine the CPU usage level.
      *
      * @return an \c int between 0 and 100 that represents the CPU usage
      */
     static int getUsage();
+
+    /**
+     * Returns the usage (between 0 and 100) of each CPU core, as calculated
+     * by the last call to \c getUsage().
+     *
+     * @note Only implemented on Linux, an empty list is returned on other
+     *       operating systems
+     */
+    static QList<int> getCoreUsage();
 };
 
 #endif /* _QDS_CPU_USAGE_H */
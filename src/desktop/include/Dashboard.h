@@ -26,6 +26,10 @@
 #include <QObject>
 #include <QProcess>
 #include <QStringList>
+#include <QElapsedTimer>
+#include <DriverStation.h>
+
+class QTimer;
 
 /**
  * @class Dashboard
@@ -37,6 +41,15 @@
  * The Dashboard application is launched as a child process, which allows
  * us to quit the Dashboard when the Open DriverStation is closed or when the
  * user selects another Dashboard type.
+ *
+ * The process is not launched until the DriverStation has connected to the
+ * robot, so that it does not compete with the DriverStation for the CPU
+ * while the application starts. Once running, the process is kept alive
+ * across reloads as long as the selected Dashboard does not change.
+ *
+ * The class also probes when the Dashboard is ready (it connected to the
+ * robot or finished loading) and samples its CPU and memory usage, which
+ * allows us to find out if the Dashboard is starving the DriverStation.
  */
 class Dashboard : public QObject
 {
@@ -53,11 +66,59 @@ public:
         LabVIEW = 0x3
     };
 
+    /**
+     * Represents the states of the Dashboard process. \c AssumedReady is
+     * used when the process could not be probed before the timeout
+     */
+    enum Status {
+        Stopped = 0x0,
+        Waiting = 0x1,
+        Starting = 0x2,
+        Ready = 0x3,
+        Crashed = 0x4,
+        AssumedReady = 0x5
+    };
+
     /**
      * Returns the only instance of this class
      */
     static Dashboard* getInstance();
 
+    /**
+     * Returns the current \c Status of the Dashboard process
+     */
+    int status();
+
+    /**
+     * Returns the CPU usage (in percent) of the Dashboard process, or -1
+     * if the process is not running or cannot be sampled
+     */
+    int cpuUsage();
+
+    /**
+     * Returns the resident memory (in kB) of the Dashboard process, or -1
+     * if the process is not running or cannot be sampled
+     */
+    qint64 residentMemory();
+
+    /**
+     * Returns the number of milliseconds that the Dashboard took to become
+     * ready after it was launched, or -1 if it is not ready yet or if it
+     * was only assumed to be ready
+     */
+    qint64 readyTime();
+
+signals:
+    /**
+     * Emitted when the Dashboard process changes its \c Status
+     */
+    void statusChanged (int status);
+
+    /**
+     * Emitted after each sample of the Dashboard process resources
+     */
+    void usageChanged (int cpu, qint64 memory);
+
 public slots:
     /**
      * Opens a Dashboard using \c QProcess based on the saved settings
@@ -70,7 +131,8 @@ public slots:
     void quitDashboard();
 
     /**
-     * Quits the current dashboard and opens a new one
+     * Opens the selected dashboard, the running process is kept alive if
+     * the selected Dashboard did not change
      */
     void reloadDashboard();
 
@@ -92,9 +154,76 @@ protected:
      */
     explicit Dashboard();
 
+private slots:
+    /**
+     * @internal
+     * Launches the Dashboard once the DriverStation is connected to the robot
+     */
+    void onStateChanged (DS_State state, int fields);
+
+    /**
+     * @internal
+     * Starts the child process of the selected Dashboard
+     */
+    void startProcess();
+
+    /**
+     * @internal
+     * Changes the status to \c Starting and begins sampling the process
+     */
+    void onStarted();
+
+    /**
+     * @internal
+     * Changes the status to \c Stopped or \c Crashed when the process ends
+     */
+    void onFinished (int exitCode, QProcess::ExitStatus exitStatus);
+
+    /**
+     * @internal
+     * Changes the status to \c Crashed if the process could not be started
+     */
+    void onError (QProcess::ProcessError error);
+
+    /**
+     * @internal
+     * Samples the resources of the process and probes if it is ready
+     */
+    void sample();
+
 private:
+    /**
+     * @internal
+     * Returns the command used to launch the given \a dashboard
+     */
+    QString getCommand (int dashboard);
+
+    /**
+     * @internal
+     * Returns \c true if the process has a TCP connection to NetworkTables
+     */
+    bool isConnected();
+
+    /**
+     * @internal
+     * Updates the status and notifies the rest of the application
+     */
+    void setStatus (Status status);
+
+    int m_status;
     int m_current;
+    int m_running;
+    int m_cpuUsage;
+    int m_idleSamples;
+    qint64 m_memory;
+    qint64 m_cpuTime;
+    qint64 m_startTime;
+    qint64 m_readyTime;
+    qint64 m_lastSample;
+
+    QTimer* m_timer;
     QProcess* m_process;
+    QElapsedTimer m_clock;
     static Dashboard* m_instance;
 };
 
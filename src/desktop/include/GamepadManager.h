@@ -24,9 +24,13 @@
 #define _QDS_GAMEPAD_MANAGER_H
 
 #include <SDL.h>
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QStringList>
 
+#include "AxisConditioner.h"
+
 /**
  * Represents a joystick and provides some information about it
  */
@@ -57,6 +61,16 @@ struct GM_Button {
     GM_Joystick joystick; /**< The joystick that the button belongs to */
 };
 
+/**
+ * Represents the complete input state of a joystick at a given moment
+ */
+struct GM_State {
+    int id;              /**< The raw ID of the joystick */
+    QList<double> axes;  /**< The values (between -1 and 1) of the axes */
+    QList<bool> buttons; /**< The states of the buttons */
+    QList<int> povs;     /**< The POV angles in degrees, -1 if centered */
+};
+
 /**
  * @class GamepadManager
  * @brief Implements an abstraction layer between SDL and Qt
@@ -66,6 +80,10 @@ struct GM_Button {
  * parses SDL events into Qt signals to easily have access to joystick data and
  * implement methods to react to joystick input.
  *
+ * The axes of each joystick are conditioned by an \c AxisConditioner, which
+ * applies the calibration, deadzone and expo settings saved for the GUID of
+ * the joystick and filters the noise of the released sticks.
+ *
  * Finally, the class uses a 'generic' mapping when it detects that an
  * unsupported controller was attached to the computer.
  * The generated mapping changes its UUID and displayname for the controller
@@ -115,7 +133,37 @@ public slots:
     QStringList joystickList();
 
     /**
-     * Initializes the event loop system.
+     * Returns the GUID of the selected \a joystick, which identifies the
+     * model of the joystick
+     */
+    QString getGuid (int joystick);
+
+    /**
+     * Returns the current state of the axes, buttons and POVs of the
+     * selected \a joystick. The returned values are the ones read during
+     * the last iteration of the SDL event loop, after conditioning the axes
+     */
+    GM_State getState (int joystick);
+
+    /**
+     * Returns the conditioning settings of the \a axis of the \a joystick
+     */
+    AC_Config getAxisConfig (int joystick, int axis);
+
+    /**
+     * Changes the conditioning settings of the \a axis of the \a joystick,
+     * the settings are saved for all the joysticks with the same GUID
+     */
+    void setAxisConfig (int joystick, int axis, AC_Config config);
+
+    /**
+     * Changes the minimum change of the axes of the \a joystick that is
+     * reported, smaller changes are considered noise and ignored
+     */
+    void setHysteresis (int joystick, double hysteresis);
+
+    /**
+     * Loads the controller mappings and initializes the event loop system.
      *
      * This function is not called in the constructor to give the application
      * time to initialize its user interface before sending signals.
@@ -159,6 +207,12 @@ signals:
      */
     void buttonEvent (GM_Button button);
 
+    /**
+     * Emitted once per iteration of the SDL event loop if the axes, buttons
+     * or POVs of any joystick changed. Use \c getState() to read them
+     */
+    void stateChanged();
+
 protected:
     /**
      * Initializes SDL, loads controller mappings and starts the event loop
@@ -178,6 +232,30 @@ private:
     static GamepadManager* m_instance;
 
     QList<int> idList;
+    QHash<int, GM_State> m_states;
+    QHash<int, SDL_Joystick*> m_handles;
+    QHash<int, AxisConditioner> m_conditioners;
+
+    /**
+     * @internal
+     * Returns the SDL handle of the selected \a joystick, the handle is
+     * opened once and re-used until a joystick is attached or removed
+     */
+    SDL_Joystick* getHandle (int joystick);
+
+    /**
+     * @internal
+     * Closes the cached joystick handles, called when the joystick indexes
+     * change because a joystick was attached or removed
+     */
+    void closeHandles();
+
+    /**
+     * @internal
+     * Reads and conditions the current state of the \a joystick and returns
+     * \c true if it is different from the last state that was read
+     */
+    bool updateState (int joystick);
 
     /**
      * @internal
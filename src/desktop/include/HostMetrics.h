@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_HOST_METRICS_H
+#define _QDS_HOST_METRICS_H
+
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QMetaType>
+#include <QAtomicInt>
+
+#include <DriverStation.h>
+
+#include "Battery.h"
+
+class QThread;
+
+/**
+ * Represents the traffic and error counters of a network interface of the
+ * host computer. The counters are totals since the interface was created.
+ */
+struct HM_Interface {
+    QString name;       /**< The name of the interface, such as 'wlan0' */
+    quint64 rxBytes;    /**< Bytes received by the interface */
+    quint64 txBytes;    /**< Bytes sent by the interface */
+    quint64 rxRate;     /**< Bytes received per second since last sample */
+    quint64 txRate;     /**< Bytes sent per second since last sample */
+    quint64 rxPackets;  /**< Packets received by the interface */
+    quint64 txPackets;  /**< Packets sent by the interface */
+    quint64 rxErrors;   /**< Receive errors reported by the driver */
+    quint64 txErrors;   /**< Transmit errors reported by the driver */
+    quint64 rxDrops;    /**< Received packets dropped by the kernel */
+    quint64 txDrops;    /**< Outgoing packets dropped by the kernel */
+    qint64 retries;     /**< Wireless MAC retries, -1 if not wireless */
+    int linkQuality;    /**< Wireless link quality, -1 if not wireless */
+    int signalLevel;    /**< Wireless signal level (dBm), 0 if unknown */
+};
+
+/**
+ * Holds the values obtained by the \c HostMetrics during a single sample.
+ * Snapshots are never modified after they are published, so they can be
+ * copied and read from any thread.
+ */
+struct HM_Snapshot {
+    qint64 timestamp;               /**< Msecs since epoch of the sample */
+    int cpuUsage;                   /**< Total CPU usage (0 to 100) */
+    QList<int> coreUsage;           /**< Usage of each CPU core (0 to 100) */
+    Battery::Status battery;        /**< Power supply status */
+    quint64 memoryTotal;            /**< Physical memory in kilobytes */
+    quint64 memoryUsed;             /**< Used physical memory in kilobytes */
+    QList<HM_Interface> interfaces; /**< Traffic of each network interface */
+    DS_LinkStats link;              /**< Packet loss and latency of the DS */
+};
+
+Q_DECLARE_METATYPE (HM_Snapshot)
+
+/**
+ * @class HostMetrics
+ * @brief Samples the resources of the host computer from a background thread
+ *
+ * The \c HostMetrics class periodically reads the CPU usage, battery status,
+ * memory usage and network traffic of the host computer from its own thread,
+ * so that slow operating system probes never stall the GUI thread.
+ *
+ * Each sample is published as an immutable \c HM_Snapshot, which is emitted
+ * with the \c snapshotChanged() signal and can also be obtained at any time
+ * with the \c snapshot() function.
+ *
+ * The snapshots also contain the packet loss and latency counters of the
+ * DriverStation, and can be written to a CSV timeline so that link problems
+ * can be attributed to the computer, the radio or the robot. The timeline is
+ * disabled by default.
+ */
+class HostMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Returns the only instance of the class
+     */
+    static HostMetrics* getInstance();
+
+    /**
+     * Returns the last snapshot published by the sampler. The function only
+     * copies the snapshot and never waits for a sample to be taken.
+     */
+    HM_Snapshot snapshot();
+
+    /**
+     * Returns the number of milliseconds between each sample
+     */
+    int interval();
+
+    /**
+     * Returns the path of the CSV file in which the network timeline is
+     * written
+     */
+    static QString timelineFile();
+
+public slots:
+    /**
+     * Starts sampling the host computer from the background thread
+     */
+    void init();
+
+    /**
+     * Changes the number of milliseconds between each sample
+     */
+    void setInterval (int interval);
+
+    /**
+     * Enables or disables writing each sample of the network interfaces
+     * and of the robot link to the timeline file. The file is kept open
+     * while the timeline is enabled.
+     */
+    void setTimelineEnabled (bool enabled);
+
+signals:
+    /**
+     * Emitted after each sample with the newly obtained \a snapshot
+     *
+     * \note The sampler runs in its own thread, so this signal is delivered
+     *       to objects that live in the GUI thread through a queued connection
+     */
+    void snapshotChanged (HM_Snapshot snapshot);
+
+protected:
+    explicit HostMetrics();
+
+private:
+    QFile m_file;
+    QMutex m_mutex;
+    QThread* m_thread;
+    QAtomicInt m_interval;
+    QAtomicInt m_timeline;
+    HM_Snapshot m_snapshot;
+
+    static HostMetrics* m_instance;
+
+    /**
+     * @internal
+     * Reads the total and used physical memory of the host computer
+     */
+    void readMemory (HM_Snapshot* snapshot);
+
+    /**
+     * @internal
+     * Reads the traffic and error counters of the network interfaces (and
+     * the statistics of the wireless ones) and calculates their transfer
+     * rates using the values of the previous snapshot
+     */
+    void readInterfaces (HM_Snapshot* snapshot);
+
+    /**
+     * @internal
+     * Opens the timeline file if it is not already open, creating its
+     * directory and writing the CSV header when needed
+     */
+    bool openTimeline();
+
+    /**
+     * @internal
+     * Appends one line per network interface to the timeline file, the file
+     * is rotated when it becomes too large
+     */
+    void writeTimeline (const HM_Snapshot& snapshot);
+
+private slots:
+    /**
+     * @internal
+     * Obtains a new snapshot, publishes it and schedules the next sample
+     */
+    void sample();
+};
+
+#endif /* _QDS_HOST_METRICS_H */
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_JOYSTICK_VIEW_H
+#define _QDS_JOYSTICK_VIEW_H
+
+#include <QWidget>
+
+#include "GamepadManager.h"
+
+/**
+ * @class JoystickView
+ * @brief Draws the axes, buttons and POVs of a joystick
+ *
+ * The \c JoystickView paints the complete state of a joystick by itself,
+ * instead of using one child widget for each axis and button. Changing the
+ * selected joystick does not create or destroy any widget, and the view is
+ * only repainted when the given state differs from the one on the screen.
+ */
+class JoystickView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit JoystickView (QWidget* parent = 0);
+
+    /**
+     * Returns the size needed to draw every axis, button and POV of the
+     * current joystick
+     */
+    QSize sizeHint() const;
+
+    /**
+     * Returns the same value as \c sizeHint()
+     */
+    QSize minimumSizeHint() const;
+
+public slots:
+    /**
+     * Changes the joystick \a state shown by the view. The view is only
+     * repainted if the \a state is different from the current one
+     */
+    void setState (const GM_State& state);
+
+    /**
+     * Removes the current state and hides all the indicators
+     */
+    void clear();
+
+protected:
+    void paintEvent (QPaintEvent* event);
+
+private:
+    GM_State m_state;
+    bool m_valid;
+
+    /**
+     * @internal
+     * Returns the number of button columns needed for the current state
+     */
+    int buttonColumns() const;
+
+    /**
+     * @internal
+     * Returns the X coordinate where the buttons are drawn
+     */
+    int buttonsOffset() const;
+
+    /**
+     * @internal
+     * Returns the X coordinate where the POVs are drawn
+     */
+    int povsOffset() const;
+};
+
+#endif /* _QDS_JOYSTICK_VIEW_H */
@@ -23,15 +23,13 @@
 #ifndef _QDS_JOYSTICKS_H
 #define _QDS_JOYSTICKS_H
 
-#include <QList>
 #include <QWidget>
 #include <QStringList>
 #include <ui_Joysticks.h>
 
 #include "GamepadManager.h"
 
-class QPushButton;
-class QProgressBar;
+class JoystickView;
 
 /**
  * @class Joysticks
@@ -72,11 +70,19 @@ signals:
      */
     void statusChanged (bool joysticksAvailable);
 
+protected:
+    /**
+     * @internal
+     * Shows the current state of the selected joystick, which is not
+     * tracked while the widget is hidden
+     */
+    void showEvent (QShowEvent* event);
+
 private:
     Ui::Joysticks ui;
+    bool m_refreshPending;
+    JoystickView* m_view;
     GamepadManager* m_manager;
-    QList<QProgressBar*> m_axes;
-    QList<QPushButton*> m_buttons;
 
 private slots:
     /**
@@ -87,7 +93,7 @@ private slots:
 
     /**
      * @internal
-     * Re-creates the indicator widgets for the currently selected joystick
+     * Shows the state of the currently selected joystick
      */
     void onRowChanged (int row);
 
@@ -100,17 +106,17 @@ private slots:
 
     /**
      * @internal
-     * Sends the axis event information to the DriverStation and updates the
-     * state of one of the axis indicators.
+     * Schedules a refresh of the joystick view on the next frame, so that
+     * the view is repainted at most once per frame no matter how many
+     * events the joysticks generate
      */
-    void onAxisEvent (GM_Axis axis);
+    void onStateChanged();
 
     /**
      * @internal
-     * Sends the button event information to the DriverStation and updates the
-     * state of one of the button indicators.
+     * Gives the current state of the selected joystick to the view
      */
-    void onButtonEvent (GM_Button button);
+    void refreshView();
 };
 
 #endif /* _QDS_JOYSTICKS_H */
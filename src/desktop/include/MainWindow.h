@@ -26,7 +26,13 @@
 #include <SmartWindow.h>
 #include <ui_MainWindow.h>
 
+#include "HostMetrics.h"
+
+class QTimer;
 class DriverStation;
+class Performance;
+class WidgetUpdater;
+class DS_ConsoleFilter;
 class AdvancedSettings;
 
 /**
@@ -50,10 +56,17 @@ public:
 
 private:
     bool m_network;
+    int m_joystickCount;
+    QString m_status;
     Ui::MainWindow ui;
 
+    QTimer* m_clockTimer;
+    QTimer* m_filterTimer;
     DriverStation* m_ds;
+    Performance* m_performance;
+    WidgetUpdater* m_updater;
     AdvancedSettings* m_advancedSettings;
+    DS_ConsoleFilter* m_consoleFilter;
 
 private slots:
     /**
@@ -79,17 +92,45 @@ private slots:
 
     /**
      * @internal
-     * Updates the values of the battery and CPU progress bars only if the
-     * main tab is currently selected.
+     * Updates the values of the battery and CPU progress bars with the
+     * \a snapshot published by the \c HostMetrics sampler
      */
-    void updatePcStatusWidgets();
+    void updatePcStatusWidgets (HM_Snapshot snapshot);
 
     /**
      * @internal
-     * Copies the output of the NetConsole to the system clipboard
+     * Copies the selected NetConsole messages to the system clipboard.
+     * If nothing is selected, the messages that match the filter are copied.
      */
     void onCopyClicked();
 
+    /**
+     * @internal
+     * Asks the user for a file name and exports the NetConsole messages to it
+     * from a background thread
+     */
+    void onExportClicked();
+
+    /**
+     * @internal
+     * Hides the export progress bar and reports the result of the export
+     */
+    void onExportFinished (bool success, QString path);
+
+    /**
+     * @internal
+     * Scrolls the NetConsole to the last message if the user was already
+     * looking at the bottom of the list
+     */
+    void onConsoleRowsInserted();
+
+    /**
+     * @internal
+     * Applies the text of the filter box to the NetConsole once the user
+     * stops typing
+     */
+    void onFilterTimeout();
+
     /**
      * @internal
      * Instructs the DriverStation library to reboot the robot
@@ -134,6 +175,20 @@ private slots:
      */
     void onJoystickRemoved();
 
+    /**
+     * @internal
+     * Updates the number of joysticks and gives their states and descriptors
+     * to the library
+     */
+    void onJoystickCountChanged (int count);
+
+    /**
+     * @internal
+     * Gives the current state of each joystick to the DriverStation library,
+     * which sends them to the robot with the next control packet
+     */
+    void updateJoystickData();
+
     /**
      * @internal
      * Changes the display mode of the window based on which button is checked
@@ -148,9 +203,10 @@ private slots:
 
     /**
      * @internal
-     * Quits the running Dashboard and opens the selected Dashboard from the
-     * 'Dashboard Type' combo. The \c db parameter must be equal to one of the
-     * Dashboard types found in the 'Dashboards' enum in Dashboard.h
+     * Saves and opens the selected Dashboard from the 'Dashboard Type' combo,
+     * the running Dashboard is only restarted if the selection changed.
+     * The \c db parameter must be equal to one of the Dashboard types found
+     * in the 'Dashboards' enum in Dashboard.h
      *
      * @param db
      */
@@ -162,6 +218,41 @@ private slots:
      */
     void setTeamNumber (int team);
 
+    /**
+     * @internal
+     * Creates the advanced settings dialog, if it does not exist yet.
+     * Called by the deferred startup tasks or when the user needs it
+     */
+    void createAdvancedSettings();
+
+    /**
+     * @internal
+     * Creates the stall watchdog and starts its thread. Called by the
+     * deferred startup tasks, so that the thread is not created before
+     * the window is interactive
+     */
+    void startWatchdog();
+
+    /**
+     * @internal
+     * Creates the host metrics sampler, starts its thread and connects it
+     * to the PC status widgets. Called by the deferred startup tasks
+     */
+    void startHostMetrics();
+
+    /**
+     * @internal
+     * Creates the advanced settings dialog if needed and shows it
+     */
+    void showAdvancedSettings();
+
+    /**
+     * @internal
+     * Writes the startup times to the NetConsole when all the deferred
+     * startup tasks have been run
+     */
+    void onStartupFinished();
+
     /**
      * @internal
      * Enables or disables the robot based on the value of \a enabled.
@@ -182,6 +273,14 @@ private slots:
      */
     void updateLabelText (QLabel* label, QString text);
 
+    /**
+     * @internal
+     * Updates the widgets that display the robot \a state. Only the
+     * widgets that correspond to the changed \a fields are updated,
+     * with the exception of the labels that depend on the network status
+     */
+    void onStateChanged (DS_State state, int fields);
+
     /**
      * @internal
      * Changes the appearance of the 'Robot Code' LED based on the value of the
@@ -231,13 +330,29 @@ private slots:
 
     /**
      * @internal
-     * Updates the text of the status label based on the operation mode of the
-     * robot. The function is pretty darn smart and can decide whenever to
-     * append 'Enabled' or 'Disabled' depending on the operation mode and status
-     * of the robot.
+     * Saves the \a status reported by the DriverStation and updates the
+     * text of the status label. The function is pretty darn smart and can
+     * decide whenever to append 'Enabled' or 'Disabled' depending on the
+     * operation mode and status of the robot.
      */
     void onRobotStatusChanged (QString status);
 
+    /**
+     * @internal
+     * Reads the match clock of the DriverStation and shows the elapsed time
+     * on the next frame. Called ten times per second while the robot is
+     * enabled, which is the resolution of the elapsed time label
+     */
+    void updateElapsedTime();
+
+    /**
+     * @internal
+     * Re-calculates the text of the status label with the last status
+     * reported by the DriverStation and the operation mode selected by
+     * the user
+     */
+    void updateStatusLabel();
+
     /**
      * @internal
      * Updates the value of the RAM usage label based on the \a total and
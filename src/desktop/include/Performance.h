@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_PERFORMANCE_H
+#define _QDS_PERFORMANCE_H
+
+#include <QDialog>
+#include <ui_Performance.h>
+
+class QTimer;
+
+/**
+ * @class Performance
+ * @brief Displays the measurements taken by the profiler of the library
+ *
+ * The \c Performance dialog shows the CPU time, memory, open files and event
+ * loop latency of the application, together with the lateness of each timer
+ * chain (robot packets, SDL events, etc).
+ *
+ * It is meant to help the user find out why the application 'lags' before
+ * a match, and to spot slow computers and performance regressions.
+ */
+class Performance : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit Performance();
+
+protected:
+    /**
+     * @internal
+     * Begins refreshing the values when the dialog is shown
+     */
+    void showEvent (QShowEvent* event);
+
+    /**
+     * @internal
+     * Stops refreshing the values when the dialog is hidden
+     */
+    void hideEvent (QHideEvent* event);
+
+private:
+    QTimer* m_timer;
+    Ui::Performance ui;
+
+private slots:
+    /**
+     * @internal
+     * Reads the profiler and updates the values of the tree, the function
+     * is called every second while the dialog is visible
+     */
+    void refresh();
+
+    /**
+     * @internal
+     * Clears the averages and worst values measured by the profiler
+     */
+    void onResetClicked();
+};
+
+#endif /* _QDS_PERFORMANCE_H */
@@ -24,16 +24,22 @@
 #define _QDS_SETTINGS_H
 
 #include <QString>
+#include <QObject>
 #include <QVariant>
 
+class QTimer;
+
 /**
  * @class Settings
- * @brief Provides a single instance of QSettings to use around the application
+ * @brief Provides a single, cached copy of the settings of the application
  *
  * The \c Settings class was implemented to provide a simple way of reading
- * and writting application settings. Another reason for its implementation
- * was to avoid the initialization of multiple QSettings objects, when in
- * fact we only need one.
+ * and writting application settings.
+ *
+ * The settings are loaded into memory the first time that the class is
+ * used, so reading or changing a value never touches the disk. Changes are
+ * written to disk by a \c SettingsWriter from a background thread a few
+ * seconds after the last change, and when the application quits.
  */
 class Settings
 {
@@ -55,4 +61,36 @@ public:
     static QVariant get (QString key, QVariant defaultValue);
 };
 
+/**
+ * @class SettingsWriter
+ * @brief Writes the changed settings to disk from a background thread
+ *
+ * @internal
+ * Each change restarts a short timer, so that a burst of changes (such
+ * as moving the window) results in a single write. If the changes never
+ * stop, the settings are written at least every few seconds.
+ */
+class SettingsWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SettingsWriter();
+
+public slots:
+    /**
+     * Restarts the timer that writes the pending changes
+     */
+    void schedule();
+
+    /**
+     * Writes the pending changes to disk right away
+     */
+    void flush();
+
+private:
+    QTimer* m_timer;
+    qint64 m_firstChange;
+};
+
 #endif /* _QDS_SETTINGS_H */
@@ -23,6 +23,7 @@
 #ifndef _QDS_SMART_WINDOW_H
 #define _QDS_SMART_WINDOW_H
 
+#include <QEvent>
 #include <QMoveEvent>
 #include <QCloseEvent>
 #include <QMainWindow>
@@ -79,6 +80,13 @@ protected:
      */
     void closeEvent (QCloseEvent* e);
 
+    /**
+     * @internal
+     * Re-calculates the size of the window when its layout changes (for
+     * example, when a widget is shown, hidden or its text changes)
+     */
+    bool event (QEvent* e);
+
 public slots:
     /**
      * If \a fixed is set to \c true, the window will resize itself to the
@@ -103,13 +111,25 @@ public slots:
     void setWindowMode (WindowMode mode);
 
 private slots:
+    /**
+     * @internal
+     * Schedules a call to \c resizeToFit() once control returns to the event
+     * loop, so that several layout and screen changes only resize the
+     * window once
+     */
+    void scheduleResize();
+
     /**
      * @internal
      * If the window is not docked and the window is configured to use a fixed
      * size, the function will resize the window to the smallest size possible
      * and will prevent the system from resizing it.
      *
-     * This function is called periodically by the window
+     * If the window is docked, the function will stretch the window to the
+     * width of the screen and move it to the bottom of the screen.
+     *
+     * This function is only called when the layout of the window, the
+     * geometry of the screen or the window mode changes
      */
     void resizeToFit();
 
@@ -117,6 +137,7 @@ private:
     int m_oldX;
     int m_oldY;
     bool m_closingDown;
+    bool m_resizePending;
     bool m_useFixedSize;
     bool m_promptOnQuit;
     WindowMode m_windowMode;
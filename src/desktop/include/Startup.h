@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_STARTUP_H
+#define _QDS_STARTUP_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QPointer>
+#include <QElapsedTimer>
+
+/**
+ * Represents a timed step of the application startup
+ */
+struct SU_Phase {
+    QString name;    /**< The name of the step */
+    qint64 start;    /**< Milliseconds since launch when the step began */
+    qint64 duration; /**< Duration of the step in milliseconds */
+    bool deferred;   /**< \c true if the step ran after the window was shown */
+    bool background; /**< \c true if the step was handed to another thread,
+                          in which case its \c duration is not known */
+};
+
+/**
+ * @class Startup
+ * @brief Times the startup of the application and runs deferred tasks
+ *
+ * The \c Startup class measures how long each phase of the startup takes,
+ * together with two milestones: the moment in which the first control packet
+ * is sent to the robot and the moment in which the event loop begins
+ * processing user input.
+ *
+ * Tasks that are not needed to control the robot (such as launching the
+ * dashboard or loading the joystick mappings) are given to \c defer() and
+ * run by priority once the window is interactive, one task per event loop
+ * iteration so that the user input is never blocked for long.
+ */
+class Startup : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Represents the priority of a deferred task
+     */
+    enum Priority {
+        High = 0,   /**< Needed shortly after the window is shown */
+        Normal = 1, /**< Background services */
+        Low = 2     /**< Things that the user may not need at all */
+    };
+
+    /**
+     * Returns the only instance of the class
+     */
+    static Startup* getInstance();
+
+    /**
+     * Returns the number of milliseconds since the application was launched
+     */
+    qint64 elapsed() const;
+
+    /**
+     * Returns the phases measured so far, in the order they were run
+     */
+    QList<SU_Phase> phases() const;
+
+    /**
+     * Returns the milliseconds needed to send the first control packet,
+     * or \c -1 if no packet has been sent yet
+     */
+    qint64 timeToFirstPacket() const;
+
+    /**
+     * Returns the milliseconds needed to process the first user input,
+     * or \c -1 if the event loop has not been started yet
+     */
+    qint64 timeToInteractive() const;
+
+public slots:
+    /**
+     * Ends the current phase (if any) and begins measuring a new one
+     */
+    void beginPhase (const QString& name);
+
+    /**
+     * Ends the current phase
+     */
+    void endPhase();
+
+    /**
+     * Marks the moment in which the first control packet was sent, later
+     * calls are ignored
+     */
+    void markFirstPacket();
+
+    /**
+     * Queues a call to the given \a method of the \a receiver, which will be
+     * run after the window becomes interactive. Tasks with the same
+     * \a priority are run in the order they were given.
+     *
+     * If the \a receiver lives in another thread, the call is only posted
+     * to it, and the phase is reported as a background step without a
+     * duration
+     */
+    void defer (const QString& name,
+                QObject* receiver,
+                const char* method,
+                Priority priority = Normal);
+
+    /**
+     * Ends the last phase and waits for the event loop to start, after
+     * which the deferred tasks are run. Must be called before
+     * \c QApplication::exec()
+     */
+    void finish();
+
+signals:
+    /**
+     * Emitted when all the deferred tasks have been run
+     */
+    void finished();
+
+protected:
+    explicit Startup();
+
+private:
+    /**
+     * Represents a task given to \c defer()
+     */
+    struct Task {
+        QString name;
+        QByteArray method;
+        Priority priority;
+        QPointer<QObject> receiver;
+    };
+
+    qint64 m_interactive;
+    qint64 m_firstPacket;
+
+    QString m_phase;
+    qint64 m_phaseStart;
+    bool m_phaseBackground;
+
+    QList<Task> m_tasks;
+    QList<SU_Phase> m_phases;
+
+    QElapsedTimer m_clock;
+    static Startup* m_instance;
+
+private slots:
+    /**
+     * @internal
+     * Marks the moment in which the event loop began processing events
+     */
+    void markInteractive();
+
+    /**
+     * @internal
+     * Runs the deferred task with the highest priority and schedules the
+     * next one for the next event loop iteration
+     */
+    void runNextTask();
+};
+
+#endif /* _QDS_STARTUP_H */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _QDS_TELEMETRY_EXPORTER_H
+#define _QDS_TELEMETRY_EXPORTER_H
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+
+#include "TelemetryStore.h"
+
+/**
+ * @class TelemetryExporter
+ * @brief Writes the values of the \c TelemetryStore to a CSV file
+ *
+ * The exporter works on a copy of the block lists of each channel. The
+ * blocks are shared with the store (only the block that is being filled is
+ * copied when the store records a new value), and they are decompressed
+ * and written from a background thread.
+ */
+class TelemetryExporter : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Prepares an export of the \a blocks of each channel to the file in
+     * \a path, the times of the values are relative to \a startTime
+     */
+    explicit TelemetryExporter (const QVector<TelemetryStore::Blocks>& blocks,
+                                qint64 startTime,
+                                const QString& path,
+                                QObject* parent = 0);
+
+signals:
+    /**
+     * Emitted when the export is complete or when the file cannot be written
+     */
+    void exportFinished (bool success, QString path);
+
+protected:
+    /**
+     * @internal
+     * Decompresses the blocks and writes their values to the file
+     */
+    void run();
+
+private:
+    QString m_path;
+    qint64 m_startTime;
+    QVector<TelemetryStore::Blocks> m_blocks;
+};
+
+#endif /* _QDS_TELEMETRY_EXPORTER_H */
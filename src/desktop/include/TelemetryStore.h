@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_TELEMETRY_STORE_H
+#define _QDS_TELEMETRY_STORE_H
+
+#include <QList>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <DriverStation.h>
+
+#include "HostMetrics.h"
+#include "ChartSeries.h"
+
+/**
+ * Represents the values recorded by the \c TelemetryStore
+ */
+enum TS_Channel {
+    TS_Voltage = 0,    /**< Battery voltage of the robot */
+    TS_PacketLoss = 1, /**< Percentage of robot packets lost */
+    TS_Latency = 2,    /**< Round trip time of the robot packets */
+    TS_CpuUsage = 3,   /**< CPU usage of the computer */
+    TS_ChannelCount = 4
+};
+
+/**
+ * Represents a single value read from the \c TelemetryStore
+ */
+struct TS_Sample {
+    qint64 time; /**< Milliseconds since the store was created */
+    float value; /**< The recorded value */
+};
+
+/**
+ * @class TelemetryStore
+ * @brief Keeps every telemetry value of the session in compressed blocks
+ *
+ * The \c TelemetryStore records the voltage, packet loss, latency and CPU
+ * usage reported during the whole session, and it is used by the charts
+ * and by the telemetry export.
+ *
+ * Each channel is stored in blocks of 256 values. Inside a block, the
+ * timestamps are saved as the difference between consecutive time deltas,
+ * and the values as the XOR with the previous value (in the same way as
+ * Facebook's Gorilla database). Regular timestamps and repeated values
+ * need one bit each. The memory used by the blocks is reported by the
+ * \c memoryUsage() function.
+ *
+ * Every block also remembers its time span and its minimum and maximum
+ * values, so that range queries can skip or summarize whole blocks without
+ * decompressing them.
+ */
+class TelemetryStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Returns the only instance of the class
+     */
+    static TelemetryStore* getInstance();
+
+    /**
+     * Returns the number of milliseconds since the store was created, this
+     * is the time base used by all the values of the store
+     */
+    qint64 time() const;
+
+    /**
+     * Returns the number of values recorded in the given \a channel
+     */
+    int count (TS_Channel channel) const;
+
+    /**
+     * Returns the number of bytes used by the compressed values
+     */
+    qint64 memoryUsage() const;
+
+    /**
+     * Divides the period between \a from and \a to in the given number of
+     * \a columns and returns the minimum and maximum values of each column.
+     * Blocks that are not wider than a column are not decompressed, their
+     * summary is drawn in the column of their middle
+     */
+    QVector<CS_Point> points (TS_Channel channel,
+                              qint64 from, qint64 to, int columns) const;
+
+    /**
+     * Returns all the values of the \a channel recorded between \a from
+     * and \a to
+     */
+    QVector<TS_Sample> samples (TS_Channel channel,
+                                qint64 from, qint64 to) const;
+
+    /**
+     * Writes every recorded value to a CSV file in the given \a path from
+     * a background thread, the \c exportFinished() signal is emitted when
+     * the file is written
+     */
+    void exportToFile (const QString& path);
+
+public slots:
+    /**
+     * Begins recording the values reported by the \c DriverStation and
+     * the \c HostMetrics
+     */
+    void init();
+
+    /**
+     * Records a new \a value of the \a channel at the current time
+     */
+    void append (TS_Channel channel, float value);
+
+signals:
+    /**
+     * Emitted when a new \a value is recorded in the \a channel
+     */
+    void sampleAdded (int channel, qint64 time, float value);
+
+    /**
+     * Emitted when an export started with \c exportToFile() finishes
+     */
+    void exportFinished (bool success, QString path);
+
+protected:
+    explicit TelemetryStore();
+
+private:
+    friend class TelemetryExporter;
+
+    /**
+     * Represents a compressed group of values
+     */
+    struct Block {
+        qint64 firstTime;  /**< Time of the first value */
+        qint64 lastTime;   /**< Time of the last value */
+        float min;         /**< Lowest value of the block */
+        float max;         /**< Highest value of the block */
+        int count;         /**< Number of values in the block */
+        int bitCount;      /**< Number of bits used in \c data */
+        QByteArray data;   /**< The compressed values */
+    };
+
+    typedef QList<Block> Blocks;
+
+    /**
+     * Represents a channel and the state of its encoder
+     */
+    struct Channel {
+        Blocks blocks;        /**< The blocks of the channel */
+        qint64 lastDelta;     /**< Last time delta of the current block */
+        quint32 lastValue;    /**< Bits of the last value */
+        int lastLeading;      /**< Leading zeros of the last XOR */
+        int lastTrailing;     /**< Trailing zeros of the last XOR */
+    };
+
+    qint64 m_startTime;
+    QElapsedTimer m_clock;
+    QVector<Channel> m_channels;
+    static TelemetryStore* m_instance;
+
+    /**
+     * @internal
+     * Compresses the \a value at the given \a time into the \a channel
+     */
+    void encode (Channel& channel, qint64 time, float value);
+
+    /**
+     * @internal
+     * Replaces the contents of \a samples with all the values of the
+     * \a block, so that one vector can be reused for every block
+     */
+    static void decode (const Block& block, QVector<TS_Sample>& samples);
+
+private slots:
+    /**
+     * @internal
+     * Records the robot voltage when the library reports a new value
+     */
+    void onStateChanged (DS_State state, int fields);
+
+    /**
+     * @internal
+     * Records the link statistics and CPU usage of a new \a snapshot
+     */
+    void onSnapshotChanged (HM_Snapshot snapshot);
+};
+
+#endif /* _QDS_TELEMETRY_STORE_H */
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_WATCHDOG_H
+#define _QDS_WATCHDOG_H
+
+#include <QQueue>
+#include <QObject>
+#include <QString>
+#include <QAtomicInt>
+#include <QStringList>
+
+class QThread;
+
+/**
+ * @class Watchdog
+ * @brief Detects and records stalls of the GUI thread
+ *
+ * The robot control packets are sent from the GUI thread, so any slot that
+ * blocks the GUI thread (for example, waiting for a \c QProcess or syncing
+ * a \c QSettings file) also delays the packets sent to the robot.
+ *
+ * The \c Watchdog runs in its own thread and posts a heartbeat event to the
+ * GUI thread every 100 milliseconds. When a heartbeat waits longer than the
+ * configured threshold, the watchdog takes a stack sample of the GUI thread
+ * (on Linux) and, once the GUI thread recovers, writes the stall duration,
+ * the number of heartbeats that were waiting in the event queue and the
+ * stack sample to a rolling diagnostics file.
+ */
+class Watchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Returns the only instance of the class
+     */
+    static Watchdog* getInstance();
+
+    /**
+     * Returns the path of the file in which the stalls are recorded
+     */
+    static QString logFile();
+
+    /**
+     * Returns the number of milliseconds that a heartbeat can wait before
+     * the GUI thread is considered to be stalled
+     */
+    int threshold();
+
+public slots:
+    /**
+     * Begins sending heartbeats to the GUI thread
+     */
+    void init();
+
+    /**
+     * Changes the number of milliseconds that a heartbeat can wait before
+     * the GUI thread is considered to be stalled
+     */
+    void setThreshold (int threshold);
+
+signals:
+    /**
+     * Emitted when the GUI thread recovers from a stall that lasted
+     * \a duration milliseconds
+     */
+    void stallDetected (int duration);
+
+protected:
+    explicit Watchdog();
+
+private:
+    int m_ticks;
+    bool m_stalled;
+    int m_backlog;
+    int m_received;
+    qint64 m_stallStart;
+    QThread* m_thread;
+    QAtomicInt m_threshold;
+    QStringList m_stack;
+    QQueue<qint64> m_heartbeats;
+
+    static Watchdog* m_instance;
+
+    /**
+     * @internal
+     * Interrupts the GUI thread and returns its current call stack
+     */
+    QStringList sampleStack();
+
+    /**
+     * @internal
+     * Appends a stall record to the diagnostics file, the file is rotated
+     * when it becomes too large
+     */
+    void writeRecord (int duration);
+
+private slots:
+    /**
+     * @internal
+     * Posts a new heartbeat, checks the age of the oldest pending heartbeat
+     * and reports the stalls of the GUI thread
+     */
+    void check();
+};
+
+#endif /* _QDS_WATCHDOG_H */
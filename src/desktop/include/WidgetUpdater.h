@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef _QDS_WIDGET_UPDATER_H
+#define _QDS_WIDGET_UPDATER_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class QLabel;
+class QAbstractButton;
+
+/**
+ * @class WidgetUpdater
+ * @brief Applies value changes to widgets at most once per frame
+ *
+ * The \c DriverStation emits some of its signals much faster than the screen
+ * can be refreshed. Instead of changing the widgets directly, the slots of
+ * the \c MainWindow give the new values to the \c WidgetUpdater, which keeps
+ * only the last value of each widget and applies it on the next frame.
+ *
+ * Values that do not differ from what the widget already shows are never
+ * applied, and the updater does not run any timer while nothing changes.
+ */
+class WidgetUpdater : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WidgetUpdater (QObject* parent = 0);
+
+public slots:
+    /**
+     * Changes the text of the \a label on the next frame
+     */
+    void setText (QLabel* label, const QString& text);
+
+    /**
+     * Changes the checked state of the \a button on the next frame
+     */
+    void setChecked (QAbstractButton* button, bool checked);
+
+private:
+    bool m_scheduled;
+    QHash<QLabel*, QString> m_texts;
+    QHash<QAbstractButton*, bool> m_checks;
+
+    /**
+     * @internal
+     * Schedules the next frame, if it was not scheduled already
+     */
+    void schedule();
+
+private slots:
+    /**
+     * @internal
+     * Applies the pending values that differ from the current ones
+     */
+    void apply();
+};
+
+#endif /* _QDS_WIDGET_UPDATER_H */
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <math.h>
+
+#include "Settings.h"
+#include "AxisConditioner.h"
+
+/* Default minimum change needed to report a new value, about one step of
+ * the 8-bit values sent to the robot */
+#define _DEFAULT_HYSTERESIS 0.01
+
+AxisConditioner::AxisConditioner()
+{
+    m_hysteresis = _DEFAULT_HYSTERESIS;
+}
+
+AC_Config AxisConditioner::defaultConfig()
+{
+    AC_Config config;
+
+    config.deadzone = 0;
+    config.expo = 0;
+    config.inverted = false;
+    config.minimum = -1;
+    config.center = 0;
+    config.maximum = 1;
+
+    return config;
+}
+
+void AxisConditioner::load (QString guid, int axes)
+{
+    m_guid = guid;
+    m_hysteresis = Settings::get (QString ("Conditioning/%1/Hysteresis")
+                                  .arg (m_guid),
+                                  _DEFAULT_HYSTERESIS).toDouble();
+
+    m_configs.resize (axes);
+    m_center.resize (axes);
+    m_lowScale.resize (axes);
+    m_highScale.resize (axes);
+    m_deadzone.resize (axes);
+    m_deadScale.resize (axes);
+    m_expo.resize (axes);
+    m_last.fill (0, axes);
+
+    AC_Config defaults = defaultConfig();
+    for (int i = 0; i < axes; ++i) {
+        AC_Config& config = m_configs[i];
+        config.deadzone = Settings::get (key (i, "Deadzone"),
+                                         defaults.deadzone).toDouble();
+        config.expo = Settings::get (key (i, "Expo"),
+                                     defaults.expo).toDouble();
+        config.inverted = Settings::get (key (i, "Inverted"),
+                                         defaults.inverted).toBool();
+        config.minimum = Settings::get (key (i, "Minimum"),
+                                        defaults.minimum).toDouble();
+        config.center = Settings::get (key (i, "Center"),
+                                       defaults.center).toDouble();
+        config.maximum = Settings::get (key (i, "Maximum"),
+                                        defaults.maximum).toDouble();
+
+        updateCoefficients (i);
+    }
+}
+
+AC_Config AxisConditioner::config (int axis) const
+{
+    if (axis >= 0 && axis < m_configs.count())
+        return m_configs.at (axis);
+
+    return defaultConfig();
+}
+
+void AxisConditioner::setConfig (int axis, AC_Config config)
+{
+    if (axis < 0 || axis >= m_configs.count())
+        return;
+
+    m_configs[axis] = config;
+    updateCoefficients (axis);
+
+    Settings::set (key (axis, "Deadzone"), config.deadzone);
+    Settings::set (key (axis, "Expo"), config.expo);
+    Settings::set (key (axis, "Inverted"), config.inverted);
+    Settings::set (key (axis, "Minimum"), config.minimum);
+    Settings::set (key (axis, "Center"), config.center);
+    Settings::set (key (axis, "Maximum"), config.maximum);
+}
+
+double AxisConditioner::hysteresis() const
+{
+    return m_hysteresis;
+}
+
+void AxisConditioner::setHysteresis (double hysteresis)
+{
+    m_hysteresis = qMax (hysteresis, 0.0);
+    Settings::set (QString ("Conditioning/%1/Hysteresis").arg (m_guid),
+                   m_hysteresis);
+}
+
+bool AxisConditioner::process (const double* input, double* output, int count)
+{
+    bool changed = false;
+    int loaded = qMin (count, m_last.count());
+
+    const double* center = m_center.constData();
+    const double* lowScale = m_lowScale.constData();
+    const double* highScale = m_highScale.constData();
+    const double* deadzone = m_deadzone.constData();
+    const double* deadScale = m_deadScale.constData();
+    const double* expo = m_expo.constData();
+    double* last = m_last.data();
+
+    /* Every step is a select or an arithmetic operation, no branches */
+    for (int i = 0; i < loaded; ++i) {
+        double value = input[i] - center[i];
+        value *= value < 0 ? lowScale[i] : highScale[i];
+        value = value < -1 ? -1 : value;
+        value = value > 1 ? 1 : value;
+
+        double magnitude = fabs (value) - deadzone[i];
+        magnitude = magnitude > 0 ? magnitude * deadScale[i] : 0;
+        magnitude += expo[i] * (magnitude * magnitude * magnitude - magnitude);
+        value = value < 0 ? -magnitude : magnitude;
+
+        /* Small moves are ignored, but the rest and end positions are not */
+        bool report = fabs (value - last[i]) >= m_hysteresis
+                      || magnitude == 0 || magnitude == 1;
+
+        output[i] = report ? value : last[i];
+        changed |= output[i] != last[i];
+        last[i] = output[i];
+    }
+
+    /* Axes that were not loaded are passed through */
+    for (int i = loaded; i < count; ++i)
+        output[i] = input[i];
+
+    return changed;
+}
+
+void AxisConditioner::updateCoefficients (int axis)
+{
+    const AC_Config& config = m_configs.at (axis);
+    double sign = config.inverted ? -1 : 1;
+    double low = config.center - config.minimum;
+    double high = config.maximum - config.center;
+    double deadzone = qBound (0.0, config.deadzone, 0.99);
+
+    m_center[axis] = config.center;
+    m_lowScale[axis] = sign / (low > 0 ? low : 1);
+    m_highScale[axis] = sign / (high > 0 ? high : 1);
+    m_deadzone[axis] = deadzone;
+    m_deadScale[axis] = 1 / (1 - deadzone);
+    m_expo[axis] = qBound (0.0, config.expo, 1.0);
+}
+
+QString AxisConditioner::key (int axis, QString name) const
+{
+    return QString ("Conditioning/%1/Axis %2/%3").arg (m_guid).arg (axis)
+           .arg (name);
+}
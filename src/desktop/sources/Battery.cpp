@@ -25,54 +25,130 @@
 #if defined _WIN32 || defined _WIN64
 #include <windows.h>
 static SYSTEM_POWER_STATUS power;
-#elif defined __APPLE__ || defined __gnu_linux__
+#endif
+
+#if defined __APPLE__
 #include <QProcess>
 #endif
 
-bool Battery::isPlugged()
+#if defined __gnu_linux__
+#include <QVector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define _SYSFS_PATH "/sys/class/power_supply"
+
+/* The uevent file of a supply holds all of its properties */
+static QVector<int> batteryFiles;
+static QVector<int> mainsFiles;
+static bool supplyListRead = false;
+static char ueventBuffer[4096];
+
+/* Returns the value of the given uevent property, or -1 if not found */
+static long long property (const char* data, const char* key)
 {
-#if defined _WIN32 || defined _WIN64
-    GetSystemPowerStatus (&power);
-    return power.ACLineStatus != 0;
-#endif
+    size_t length = strlen (key);
+    const char* line = data;
 
-#if defined __APPLE__
-    QByteArray data;
-    QProcess process;
+    while (line != nullptr && *line != 0) {
+        if (strncmp (line, "POWER_SUPPLY_", 13) == 0
+                && strncmp (line + 13, key, length) == 0
+                && line[13 + length] == '=')
+            return strtoll (line + 14 + length, nullptr, 10);
 
-    process.start ("pmset -g batt");
+        line = strchr (line, '\n');
+        if (line != nullptr)
+            ++line;
+    }
 
-    while (process.waitForReadyRead())
-        data.append (process.readAll());
+    return -1;
+}
 
-    if (data.contains ("discharging"))
+/* Re-reads an open uevent file, returns false if the supply is gone */
+static bool readUevent (int file)
+{
+    ssize_t length = pread (file, ueventBuffer, sizeof (ueventBuffer) - 1, 0);
+    if (length <= 0)
         return false;
 
+    ueventBuffer[length] = 0;
     return true;
-#endif
+}
 
-#if defined __gnu_linux__
-    QByteArray data;
-    QProcess process;
+/* Opens the uevent files of the power supplies, sorted by type */
+static void readSupplyList()
+{
+    for (int i = 0; i < batteryFiles.count(); ++i)
+        close (batteryFiles.at (i));
+    for (int i = 0; i < mainsFiles.count(); ++i)
+        close (mainsFiles.at (i));
 
-    process.start ("bash -c \"upower -i $(upower -e | grep 'BAT') | "
-                   "grep -E 'state|to\\ full|percentage'\"");
+    batteryFiles.clear();
+    mainsFiles.clear();
+    supplyListRead = true;
 
-    while (process.waitForReadyRead())
-        data.append (process.readAll());
+    DIR* directory = opendir (_SYSFS_PATH);
+    if (directory == nullptr)
+        return;
 
-    if (data.contains ("discharging"))
-        return false;
+    struct dirent* entry;
+    while ((entry = readdir (directory)) != nullptr) {
+        if (entry->d_name[0] == '.')
+            continue;
 
-    return true;
-#endif
+        char path[512];
+        snprintf (path, sizeof (path), "%s/%s/uevent",
+                  _SYSFS_PATH, entry->d_name);
+
+        int file = open (path, O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+            continue;
+
+        /* Sort the supply by its type, ignore peripherals (e.g. mice) */
+        bool valid = readUevent (file);
+        if (valid && strstr (ueventBuffer, "SCOPE=Device") == nullptr) {
+            if (strstr (ueventBuffer, "TYPE=Battery")) {
+                batteryFiles.append (file);
+                continue;
+            }
+
+            if (strstr (ueventBuffer, "TYPE=Mains")) {
+                mainsFiles.append (file);
+                continue;
+            }
+        }
+
+        close (file);
+    }
+
+    closedir (directory);
 }
+#endif
 
-int Battery::currentLevel()
+Battery::Status Battery::readStatus()
 {
+    Status status;
+    status.plugged = true;
+    status.discharging = false;
+    status.level = 0;
+    status.power = -1;
+    status.timeToEmpty = -1;
+
 #if defined _WIN32 || defined _WIN64
     GetSystemPowerStatus (&power);
-    return static_cast<int> (power.BatteryLifePercent);
+    status.plugged = power.ACLineStatus != 0;
+    status.discharging = !status.plugged;
+
+    if (power.BatteryLifePercent <= 100)
+        status.level = static_cast<int> (power.BatteryLifePercent);
+
+    if (power.BatteryLifeTime != static_cast<DWORD> (-1))
+        status.timeToEmpty = static_cast<int> (power.BatteryLifeTime / 60);
 #endif
 
 #if defined __APPLE__
@@ -84,6 +160,9 @@ int Battery::currentLevel()
     while (process.waitForReadyRead())
         data.append (process.readAll());
 
+    status.discharging = data.contains ("discharging");
+    status.plugged = !status.discharging;
+
     /* Parse the digits of the percentage */
     int h = data.at (data.indexOf ("%") - 3) - '0'; // Hundreds
     int t = data.at (data.indexOf ("%") - 2) - '0'; // Tens
@@ -94,29 +173,104 @@ int Battery::currentLevel()
     if (t < 0) t = 0;
     if (u < 0) u = 0;
 
-    return (h * 100) + (t * 10) + u;
+    status.level = (h * 100) + (t * 10) + u;
 #endif
 
 #if defined __gnu_linux__
-    QByteArray data;
-    QProcess process;
+    /* Look for the power supplies again if one of them disappeared */
+    if (!supplyListRead)
+        readSupplyList();
 
-    process.start ("bash -c \"upower -i $(upower -e | grep 'BAT') | "
-                   "grep -E 'state|to\\ full|percentage'\"");
+    /* Only trust the mains supplies if there are any */
+    if (!mainsFiles.isEmpty()) {
+        status.plugged = false;
+        for (int i = 0; i < mainsFiles.count(); ++i) {
+            if (!readUevent (mainsFiles.at (i)))
+                supplyListRead = false;
 
-    while (process.waitForReadyRead())
-        data.append (process.readAll());
+            else if (property (ueventBuffer, "ONLINE") == 1)
+                status.plugged = true;
+        }
+    }
 
-    /* Parse the digits of the percentage */
-    int h = data.at (data.indexOf ("%") - 3) - '0'; // Hundreds
-    int t = data.at (data.indexOf ("%") - 2) - '0'; // Tens
-    int u = data.at (data.indexOf ("%") - 1) - '0'; // Units
+    /* Energy is in uWh and power in uW, charge is in uAh and current in uA */
+    long long now = 0;
+    long long full = 0;
+    long long draw = 0;
+    long long capacity = 0;
+    int batteries = 0;
 
-    /* If the character is shit then make the value 0 */
-    if (h < 0) h = 0;
-    if (t < 0) t = 0;
-    if (u < 0) u = 0;
+    for (int i = 0; i < batteryFiles.count(); ++i) {
+        /* The supply was removed (e.g. a hot-swapped battery) */
+        if (!readUevent (batteryFiles.at (i))) {
+            supplyListRead = false;
+            continue;
+        }
+
+        if (property (ueventBuffer, "PRESENT") == 0)
+            continue;
+
+        ++batteries;
+        capacity += qMax (property (ueventBuffer, "CAPACITY"), 0LL);
 
-    return (h * 100) + (t * 10) + u;
+        if (strstr (ueventBuffer, "STATUS=Discharging"))
+            status.discharging = true;
+
+        long long energyNow = property (ueventBuffer, "ENERGY_NOW");
+        long long energyFull = property (ueventBuffer, "ENERGY_FULL");
+        long long powerNow = property (ueventBuffer, "POWER_NOW");
+
+        /* Convert charge based values using the current voltage */
+        if (energyNow < 0) {
+            long long voltage = property (ueventBuffer, "VOLTAGE_NOW");
+            long long chargeNow = property (ueventBuffer, "CHARGE_NOW");
+            long long chargeFull = property (ueventBuffer, "CHARGE_FULL");
+            long long currentNow = property (ueventBuffer, "CURRENT_NOW");
+
+            if (voltage > 0) {
+                voltage /= 1000;
+                energyNow = chargeNow >= 0 ? chargeNow * voltage / 1000 : -1;
+                energyFull = chargeFull >= 0 ? chargeFull * voltage / 1000 : -1;
+                powerNow = currentNow >= 0 ? currentNow * voltage / 1000 : -1;
+            }
+        }
+
+        if (energyNow >= 0 && energyFull > 0) {
+            now += energyNow;
+            full += energyFull;
+        }
+
+        if (powerNow >= 0)
+            draw += powerNow;
+    }
+
+    if (batteries > 0) {
+        /* Weight the level of each battery by its size when possible */
+        if (full > 0)
+            status.level = static_cast<int> ((now * 100) / full);
+        else
+            status.level = static_cast<int> (capacity / batteries);
+
+        status.power = static_cast<int> (draw / 1000);
+
+        if (status.discharging && draw > 0)
+            status.timeToEmpty = static_cast<int> ((now * 60) / draw);
+    }
+
+    /* Some laptops do not report a mains supply */
+    if (mainsFiles.isEmpty())
+        status.plugged = !status.discharging;
 #endif
+
+    return status;
+}
+
+bool Battery::isPlugged()
+{
+    return readStatus().plugged;
+}
+
+int Battery::currentLevel()
+{
+    return readStatus().level;
 }
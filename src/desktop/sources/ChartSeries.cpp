@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ChartSeries.h"
+
+/* Number of points kept by each ring buffer */
+#define _CAPACITY 4096
+
+/* Number of points of a level that are merged into a point of the next */
+#define _FACTOR 8
+
+/* Number of ring buffers, enough for ~87 minutes of values at 50 Hz */
+#define _LEVELS 3
+
+ChartSeries::ChartSeries()
+{
+    m_levels.resize (_LEVELS);
+
+    for (int i = 0; i < m_levels.count(); ++i)
+        m_levels[i].ring.resize (_CAPACITY);
+
+    clear();
+}
+
+bool ChartSeries::isEmpty() const
+{
+    return m_levels.first().count == 0;
+}
+
+float ChartSeries::lastValue() const
+{
+    const Level& level = m_levels.first();
+
+    if (level.count == 0)
+        return 0;
+
+    return level.ring.at ((level.head + _CAPACITY - 1) % _CAPACITY).max;
+}
+
+void ChartSeries::append (qint64 time, float value)
+{
+    CS_Point point;
+    point.time = time;
+    point.min = value;
+    point.max = value;
+
+    push (0, point);
+}
+
+void ChartSeries::clear()
+{
+    for (int i = 0; i < m_levels.count(); ++i) {
+        m_levels[i].head = 0;
+        m_levels[i].count = 0;
+        m_levels[i].pendingCount = 0;
+    }
+}
+
+QVector<CS_Point> ChartSeries::points (qint64 from, qint64 to,
+                                       int columns) const
+{
+    QVector<CS_Point> result;
+
+    if (isEmpty() || columns <= 0 || to <= from)
+        return result;
+
+    int index = levelFor (from);
+    QVector<CS_Point> bins (columns);
+    QVector<bool> used (columns, false);
+
+    /* Read the finished points of the selected level */
+    QVector<CS_Point> source;
+    const Level& level = m_levels.at (index);
+    int first = (level.head + _CAPACITY - level.count) % _CAPACITY;
+    source.reserve (level.count + index);
+    for (int i = 0; i < level.count; ++i)
+        source.append (level.ring.at ((first + i) % _CAPACITY));
+
+    /* The newest values are still being merged in the finer levels */
+    for (int i = index; i > 0; --i) {
+        if (m_levels.at (i).pendingCount > 0)
+            source.append (m_levels.at (i).pending);
+    }
+
+    for (int i = 0; i < source.count(); ++i) {
+        const CS_Point& point = source.at (i);
+
+        if (point.time < from || point.time > to)
+            continue;
+
+        int column = (point.time - from) * (columns - 1) / (to - from);
+
+        if (!used.at (column)) {
+            used[column] = true;
+            bins[column] = point;
+        }
+
+        else {
+            bins[column].min = qMin (bins.at (column).min, point.min);
+            bins[column].max = qMax (bins.at (column).max, point.max);
+        }
+    }
+
+    for (int i = 0; i < columns; ++i) {
+        if (used.at (i))
+            result.append (bins.at (i));
+    }
+
+    return result;
+}
+
+void ChartSeries::push (int level, const CS_Point& point)
+{
+    Level& current = m_levels[level];
+
+    current.ring[current.head] = point;
+    current.head = (current.head + 1) % _CAPACITY;
+    current.count = qMin (current.count + 1, _CAPACITY);
+
+    if (level + 1 >= m_levels.count())
+        return;
+
+    /* Merge the point into the next level */
+    Level& next = m_levels[level + 1];
+    if (next.pendingCount == 0)
+        next.pending = point;
+
+    else {
+        next.pending.min = qMin (next.pending.min, point.min);
+        next.pending.max = qMax (next.pending.max, point.max);
+    }
+
+    /* Write the merged point when it holds enough points */
+    if (++next.pendingCount >= _FACTOR) {
+        next.pendingCount = 0;
+        push (level + 1, next.pending);
+    }
+}
+
+int ChartSeries::levelFor (qint64 time) const
+{
+    for (int i = 0; i < m_levels.count(); ++i) {
+        const Level& level = m_levels.at (i);
+
+        /* The level has never overwritten a point, it has all the values */
+        if (level.count < _CAPACITY)
+            return i;
+
+        /* The oldest point of the level is older than the given time */
+        if (level.ring.at (level.head).time <= time)
+            return i;
+    }
+
+    return m_levels.count() - 1;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QPainter>
+
+#include "ChartView.h"
+#include "ChartSeries.h"
+
+/* Height of the title and value text */
+#define _TEXT_HEIGHT 14
+
+/* Colors of the chart background and grid */
+#define _BACKGROUND_COLOR QColor (38, 38, 38)
+#define _GRID_COLOR QColor (64, 64, 64)
+
+ChartView::ChartView (const QString& title,
+                      const QString& units,
+                      const QColor& color,
+                      TS_Channel channel,
+                      ChartSeries* series,
+                      QWidget* parent) : QWidget (parent)
+{
+    m_color = color;
+    m_channel = channel;
+    m_title = title;
+    m_units = units;
+    m_series = series;
+
+    m_now = 0;
+    m_window = 60 * 1000;
+    m_minimum = 0;
+    m_maximum = 0;
+}
+
+QSize ChartView::sizeHint() const
+{
+    return QSize (240, 90);
+}
+
+void ChartView::setRange (float minimum, float maximum)
+{
+    m_minimum = minimum;
+    m_maximum = maximum;
+    update();
+}
+
+void ChartView::setWindow (qint64 now, qint64 window)
+{
+    m_now = now;
+    m_window = window;
+    update();
+}
+
+void ChartView::paintEvent (QPaintEvent* event)
+{
+    Q_UNUSED (event);
+
+    QPainter painter (this);
+    QRect plot = rect().adjusted (0, _TEXT_HEIGHT, -1, -1);
+
+    /* Draw the title and the last value */
+    painter.setPen (palette().color (QPalette::WindowText));
+    painter.drawText (QRect (0, 0, width(), _TEXT_HEIGHT),
+                      Qt::AlignLeft | Qt::AlignVCenter, m_title);
+
+    if (!m_series->isEmpty())
+        painter.drawText (QRect (0, 0, width(), _TEXT_HEIGHT),
+                          Qt::AlignRight | Qt::AlignVCenter,
+                          QString ("%1 %2")
+                          .arg (m_series->lastValue(), 0, 'f', 1)
+                          .arg (m_units));
+
+    painter.fillRect (plot, _BACKGROUND_COLOR);
+
+    /* Get one point for each pixel column */
+    qint64 from = m_window > 0 ? m_now - m_window : 0;
+    QVector<CS_Point> points;
+
+    if (m_window > 0)
+        points = m_series->points (from, m_now, plot.width());
+    else
+        points = TelemetryStore::getInstance()->points (m_channel, from,
+                                                        m_now, plot.width());
+
+    if (points.isEmpty())
+        return;
+
+    /* Calculate the vertical range */
+    float minimum = m_minimum;
+    float maximum = m_maximum;
+    if (maximum <= minimum) {
+        minimum = points.first().min;
+        maximum = points.first().max;
+
+        foreach (const CS_Point& point, points) {
+            minimum = qMin (minimum, point.min);
+            maximum = qMax (maximum, point.max);
+        }
+
+        if (maximum <= minimum)
+            maximum = minimum + 1;
+    }
+
+    /* Draw a horizontal line in the middle of the range */
+    painter.setPen (_GRID_COLOR);
+    painter.drawLine (plot.left(), plot.center().y(),
+                      plot.right(), plot.center().y());
+
+    /* Draw the range of each column and join it with the previous one */
+    float scale = plot.height() / (maximum - minimum);
+    painter.setPen (m_color);
+
+    int lastX = -1;
+    int lastY = 0;
+    foreach (const CS_Point& point, points) {
+        int x = plot.left() + (point.time - from)
+                * (plot.width() - 1) / qMax (m_now - from, (qint64) 1);
+
+        float low = qBound (minimum, point.min, maximum);
+        float high = qBound (minimum, point.max, maximum);
+
+        int top = plot.bottom() - qRound ((high - minimum) * scale);
+        int bottom = plot.bottom() - qRound ((low - minimum) * scale);
+
+        if (lastX >= 0)
+            painter.drawLine (lastX, lastY, x, (top + bottom) / 2);
+
+        painter.drawLine (x, top, x, bottom);
+
+        lastX = x;
+        lastY = (top + bottom) / 2;
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QLabel>
+#include <QTimer>
+#include <QComboBox>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include <DriverStation.h>
+
+#include "Charts.h"
+#include "Settings.h"
+#include "ChartView.h"
+
+/* Milliseconds between each repaint of the charts */
+#define _REFRESH_INTERVAL 250
+
+Charts::Charts (QWidget* parent) : QWidget (parent)
+{
+    /* Create the period selector */
+    m_windowCombo = new QComboBox (this);
+    m_windowCombo->addItem (tr ("Last minute"), 60 * 1000);
+    m_windowCombo->addItem (tr ("Last 5 minutes"), 5 * 60 * 1000);
+    m_windowCombo->addItem (tr ("Last 30 minutes"), 30 * 60 * 1000);
+    m_windowCombo->addItem (tr ("Whole session"), 0);
+    m_windowCombo->setCurrentIndex (Settings::get ("Charts Window", 0).toInt());
+
+    QHBoxLayout* header = new QHBoxLayout();
+    header->addWidget (new QLabel (tr ("Show:"), this));
+    header->addWidget (m_windowCombo);
+    header->addStretch();
+
+    QPushButton* exportButton = new QPushButton (tr ("Export..."), this);
+    header->addWidget (exportButton);
+
+    /* Create the charts */
+    ChartView* voltage = new ChartView (tr ("Voltage"), tr ("V"),
+                                        QColor (255, 200, 33),
+                                        TS_Voltage, &m_series[TS_Voltage],
+                                        this);
+    ChartView* loss = new ChartView (tr ("Packet loss"), tr ("%"),
+                                     QColor (255, 33, 43),
+                                     TS_PacketLoss, &m_series[TS_PacketLoss],
+                                     this);
+    ChartView* latency = new ChartView (tr ("Round trip time"), tr ("ms"),
+                                        QColor (33, 150, 255),
+                                        TS_Latency, &m_series[TS_Latency],
+                                        this);
+    ChartView* cpu = new ChartView (tr ("CPU usage"), tr ("%"),
+                                    QColor (33, 255, 43),
+                                    TS_CpuUsage, &m_series[TS_CpuUsage],
+                                    this);
+
+    voltage->setRange (0, 14);
+    loss->setRange (0, 100);
+    cpu->setRange (0, 100);
+
+    m_views.append (voltage);
+    m_views.append (loss);
+    m_views.append (latency);
+    m_views.append (cpu);
+
+    QGridLayout* grid = new QGridLayout();
+    grid->addWidget (voltage, 0, 0);
+    grid->addWidget (loss, 0, 1);
+    grid->addWidget (latency, 1, 0);
+    grid->addWidget (cpu, 1, 1);
+
+    QVBoxLayout* layout = new QVBoxLayout (this);
+    layout->setContentsMargins (0, 0, 0, 0);
+    layout->addLayout (header);
+    layout->addLayout (grid);
+
+    /* Configure the repaint timer */
+    m_timer = new QTimer (this);
+    m_timer->setInterval (_REFRESH_INTERVAL);
+
+    connect (m_timer,       SIGNAL (timeout()),
+             this,          SLOT   (refresh()));
+    connect (m_windowCombo, SIGNAL (currentIndexChanged (int)),
+             this,          SLOT   (onWindowChanged (int)));
+    connect (exportButton,  SIGNAL (clicked()),
+             this,          SLOT   (onExportClicked()));
+
+    /* Copy the recorded values to the chart series */
+    connect (TelemetryStore::getInstance(),
+             SIGNAL (sampleAdded   (int, qint64, float)),
+             this,
+             SLOT   (onSampleAdded (int, qint64, float)));
+    connect (TelemetryStore::getInstance(),
+             SIGNAL (exportFinished   (bool, QString)),
+             this,
+             SLOT   (onExportFinished (bool, QString)));
+}
+
+void Charts::showEvent (QShowEvent* event)
+{
+    QWidget::showEvent (event);
+
+    refresh();
+    m_timer->start();
+}
+
+void Charts::hideEvent (QHideEvent* event)
+{
+    QWidget::hideEvent (event);
+    m_timer->stop();
+}
+
+void Charts::refresh()
+{
+    qint64 window = m_windowCombo->itemData (
+                        m_windowCombo->currentIndex()).toLongLong();
+
+    foreach (ChartView* view, m_views)
+        view->setWindow (TelemetryStore::getInstance()->time(), window);
+}
+
+void Charts::onWindowChanged (int index)
+{
+    Settings::set ("Charts Window", index);
+    refresh();
+}
+
+void Charts::onExportClicked()
+{
+    QString path = QFileDialog::getSaveFileName (this,
+                                                 tr ("Export Telemetry"),
+                                                 QDir::homePath(),
+                                                 tr ("CSV files (*.csv)"));
+
+    if (path.isEmpty())
+        return;
+
+    TelemetryStore::getInstance()->exportToFile (path);
+}
+
+void Charts::onExportFinished (bool success, QString path)
+{
+    DS_ConsoleStore* console = DriverStation::getInstance()->consoleStore();
+
+    if (success)
+        console->append (tr ("INFO: Telemetry exported to %1").arg (path));
+    else
+        console->append (tr ("ERROR: Cannot write to %1").arg (path));
+}
+
+void Charts::onSampleAdded (int channel, qint64 time, float value)
+{
+    if (channel >= 0 && channel < TS_ChannelCount)
+        m_series[channel].append (time, value);
+}
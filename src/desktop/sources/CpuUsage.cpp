@@ -22,6 +22,8 @@
 
 #include "CpuUsage.h"
 
+#include <QVector>
+
 #if defined _WIN32 || defined _WIN64
 #include <pdh.h>
 #include <tchar.h>
@@ -31,10 +33,31 @@ static PDH_HCOUNTER cpuTotal;
 #define COUNTER_PATH L"\\Processor(_Total)\\% Processor Time"
 #endif
 
-#if defined __APPLE__ || defined __gnu_linux__
+#if defined __APPLE__
 #include <QProcess>
 #endif
 
+#if defined __gnu_linux__
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Large enough for the 'cpu' lines of machines with hundreds of cores */
+#define _STAT_BUFFER_SIZE 32768
+
+/* Counters of the previous sample, the first entry is the aggregate 'cpu' */
+static QVector<quint64> previousBusy;
+static QVector<quint64> previousTotal;
+
+/* /proc/stat is kept open and re-read from the beginning on each sample */
+static int statFile = -1;
+static char statBuffer[_STAT_BUFFER_SIZE];
+#endif
+
+/* Per-core usage values calculated by the last call to getUsage() */
+static QList<int> coreUsage;
+
 void CpuUsage::init()
 {
 #if defined _WIN32 || defined _WIN64
@@ -76,26 +99,75 @@ int CpuUsage::getUsage()
 #endif
 
 #if defined __gnu_linux__
-    QByteArray data;
-    QProcess process;
-
-    /* Launch a CLI command that gives us the CPU usage */
-    process.start ("bash -c \"grep 'cpu ' /proc/stat | "
-                   "awk '{usage=($2+$4)*100/($2+$4+$5)} "
-                   "END {print usage}'\"");
-
-    /* Read process output */
-    while (process.waitForReadyRead())
-        data.append (process.readAll());
-
-    /* Parse the digits of the percentage */
-    int t = data.at (0) - '0';
-    int u = data.at (1) - '0';
-
-    /* If the character is shit then make the value 0 */
-    if (t < 0) t = 0;
-    if (u < 0) u = 0;
-
-    return (t * 10) + u;
+    if (statFile < 0)
+        statFile = open ("/proc/stat", O_RDONLY | O_CLOEXEC);
+
+    ssize_t length = pread (statFile, statBuffer, _STAT_BUFFER_SIZE - 1, 0);
+    if (length <= 0)
+        return 0;
+
+    statBuffer[length] = 0;
+
+    int index = 0;
+    int usage = 0;
+    char* line = statBuffer;
+    coreUsage.clear();
+
+    /* The 'cpu' lines are always the first lines of the file */
+    while (strncmp (line, "cpu", 3) == 0) {
+        char* cursor = line + 3;
+        while (*cursor != ' ' && *cursor != 0)
+            ++cursor;
+
+        /* user nice system idle iowait irq softirq steal */
+        quint64 fields[8] = {0};
+        for (int i = 0; i < 8; ++i)
+            fields[i] = strtoull (cursor, &cursor, 10);
+
+        quint64 idle = fields[3] + fields[4];
+        quint64 total = 0;
+        for (int i = 0; i < 8; ++i)
+            total += fields[i];
+
+        quint64 busy = total - idle;
+
+        /* Calculate the usage since the previous sample */
+        int value = 0;
+        if (index < previousTotal.count()) {
+            quint64 deltaBusy = busy - previousBusy.at (index);
+            quint64 deltaTotal = total - previousTotal.at (index);
+
+            if (deltaTotal > 0 && busy >= previousBusy.at (index))
+                value = static_cast<int> ((deltaBusy * 100) / deltaTotal);
+
+            previousBusy[index] = busy;
+            previousTotal[index] = total;
+        }
+
+        else {
+            previousBusy.append (busy);
+            previousTotal.append (total);
+        }
+
+        if (index == 0)
+            usage = value;
+        else
+            coreUsage.append (value);
+
+        /* Go to the next line */
+        line = strchr (line, '\n');
+        if (line == nullptr)
+            break;
+
+        ++line;
+        ++index;
+    }
+
+    return usage;
 #endif
 }
+
+QList<int> CpuUsage::getCoreUsage()
+{
+    return coreUsage;
+}
@@ -21,6 +21,8 @@
  */
 
 #include <QDir>
+#include <QFile>
+#include <QTimer>
 #include <QApplication>
 
 #include "Settings.h"
@@ -29,6 +31,7 @@
 /* Decide whenever to use 'Program Files' or 'Program Files (x86)' */
 #if defined _WIN32 || defined _WIN64
 #include <windows.h>
+#include <psapi.h>
 #define is64Bits true
 #if _WIN32
 #undef is64Bits
@@ -37,6 +40,26 @@
 #endif
 #endif
 
+#if defined __gnu_linux__
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+/* Milliseconds between each sample of the Dashboard process */
+#define _SAMPLE_INTERVAL 1000
+
+/* The Dashboard is considered idle below this CPU usage (in percent) */
+#define _IDLE_CPU_USAGE 10
+
+/* Number of idle samples after which a loading Dashboard is ready */
+#define _IDLE_SAMPLES 2
+
+/* Milliseconds after which a Dashboard that cannot be probed is ready */
+#define _READY_TIMEOUT 15000
+
+/* TCP port used by NetworkTables, the Dashboards connect to it */
+#define _NT_PORT 1735
+
 Dashboard* Dashboard::m_instance = nullptr;
 
 //------------------------------------------------------------------------------
@@ -45,10 +68,36 @@ Dashboard* Dashboard::m_instance = nullptr;
 
 Dashboard::Dashboard()
 {
+    m_status = Stopped;
+    m_running = None;
+    m_cpuUsage = -1;
+    m_memory = -1;
+    m_cpuTime = -1;
+    m_readyTime = -1;
+    m_startTime = -1;
+    m_lastSample = -1;
+    m_idleSamples = 0;
+
+    m_clock.start();
+    m_timer = new QTimer (this);
+    m_timer->setInterval (_SAMPLE_INTERVAL);
     m_process = new QProcess (this);
-    connect (qApp, SIGNAL (aboutToQuit()), this, SLOT (quitDashboard()));
+    m_current = Settings::get ("Dashboard", None).toInt();
 
-    loadDashboard();
+    connect (m_timer,   SIGNAL (timeout()),
+             this,        SLOT (sample()));
+    connect (m_process, SIGNAL (started()),
+             this,        SLOT (onStarted()));
+    connect (m_process, SIGNAL (finished  (int, QProcess::ExitStatus)),
+             this,        SLOT (onFinished (int, QProcess::ExitStatus)));
+    connect (m_process, SIGNAL (error   (QProcess::ProcessError)),
+             this,        SLOT (onError (QProcess::ProcessError)));
+
+    connect (DriverStation::getInstance(),
+             SIGNAL (stateChanged   (DS_State, int)),
+             this, SLOT (onStateChanged (DS_State, int)));
+
+    connect (qApp, SIGNAL (aboutToQuit()), this, SLOT (quitDashboard()));
 }
 
 Dashboard* Dashboard::getInstance()
@@ -65,10 +114,194 @@ Dashboard* Dashboard::getInstance()
 
 void Dashboard::loadDashboard()
 {
-    QString path;
     m_current = Settings::get ("Dashboard", None).toInt();
 
-    switch (m_current) {
+    /* The selection did not change, keep the running process */
+    if (m_running == m_current && m_process->state() != QProcess::NotRunning)
+        return;
+
+    quitDashboard();
+
+    if (getCommand (m_current).isEmpty())
+        return;
+
+    /* Do not compete with the DriverStation until the robot is connected */
+    if (DriverStation::getInstance()->state().network)
+        startProcess();
+    else
+        setStatus (Waiting);
+}
+
+void Dashboard::quitDashboard()
+{
+    m_running = None;
+    m_timer->stop();
+    m_process->close();
+
+    setStatus (Stopped);
+}
+
+void Dashboard::reloadDashboard()
+{
+    loadDashboard();
+}
+
+void Dashboard::onStateChanged (DS_State state, int fields)
+{
+    if ((fields & DS_NetworkField) && state.network && m_status == Waiting)
+        startProcess();
+}
+
+void Dashboard::startProcess()
+{
+    m_running = m_current;
+    m_readyTime = -1;
+    m_startTime = m_clock.elapsed();
+
+    setStatus (Starting);
+    m_process->start (getCommand (m_running));
+}
+
+void Dashboard::onStarted()
+{
+    m_memory = -1;
+    m_cpuTime = -1;
+    m_cpuUsage = -1;
+    m_idleSamples = 0;
+    m_lastSample = -1;
+
+    m_timer->start();
+}
+
+void Dashboard::onFinished (int exitCode, QProcess::ExitStatus exitStatus)
+{
+    m_timer->stop();
+    m_memory = -1;
+    m_cpuUsage = -1;
+
+    /* The process was not closed by us */
+    if (m_running != None) {
+        m_running = None;
+        setStatus (exitStatus == QProcess::CrashExit || exitCode != 0 ?
+                   Crashed : Stopped);
+    }
+
+    emit usageChanged (m_cpuUsage, m_memory);
+}
+
+void Dashboard::onError (QProcess::ProcessError error)
+{
+    if (error == QProcess::FailedToStart && m_running != None) {
+        m_running = None;
+        setStatus (Crashed);
+
+        DriverStation::getInstance()->consoleStore()->append (
+            tr ("ERROR: Cannot launch the dashboard (%1)")
+            .arg (m_process->errorString()));
+    }
+}
+
+void Dashboard::sample()
+{
+    qint64 cpuTime = -1;
+    qint64 memory = -1;
+    qint64 pid = m_process->processId();
+
+#if defined _WIN32 || defined _WIN64
+    HANDLE process = OpenProcess (PROCESS_QUERY_LIMITED_INFORMATION, FALSE,
+                                  static_cast<DWORD> (pid));
+
+    if (process != nullptr) {
+        /* FILETIME values are expressed in units of 100 nanoseconds */
+        FILETIME creation, exited, kernel, user;
+        if (GetProcessTimes (process, &creation, &exited, &kernel, &user)) {
+            ULARGE_INTEGER k, u;
+            k.LowPart = kernel.dwLowDateTime;
+            k.HighPart = kernel.dwHighDateTime;
+            u.LowPart = user.dwLowDateTime;
+            u.HighPart = user.dwHighDateTime;
+            cpuTime = static_cast<qint64> ((k.QuadPart + u.QuadPart) / 10000);
+        }
+
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo (process, &counters, sizeof (counters)))
+            memory = static_cast<qint64> (counters.WorkingSetSize / 1024);
+
+        CloseHandle (process);
+    }
+#endif
+
+#if defined __gnu_linux__
+    /* The utime and stime fields follow the (possibly spaced) process name */
+    QFile stat (QString ("/proc/%1/stat").arg (pid));
+    if (stat.open (QFile::ReadOnly)) {
+        QByteArray data = stat.readAll();
+        QList<QByteArray> fields = data.mid (data.lastIndexOf (')') + 2)
+                                   .split (' ');
+
+        if (fields.count() > 12) {
+            qint64 ticks = fields.at (11).toLongLong()
+                           + fields.at (12).toLongLong();
+            cpuTime = ticks * 1000 / sysconf (_SC_CLK_TCK);
+        }
+    }
+
+    /* The second field of statm is the number of resident pages */
+    QFile statm (QString ("/proc/%1/statm").arg (pid));
+    if (statm.open (QFile::ReadOnly)) {
+        QList<QByteArray> fields = statm.readAll().split (' ');
+        if (fields.count() > 1) {
+            memory = fields.at (1).toLongLong()
+                     * (sysconf (_SC_PAGESIZE) / 1024);
+        }
+    }
+#endif
+
+    qint64 now = m_clock.elapsed();
+
+    if (cpuTime >= 0 && m_cpuTime >= 0 && now > m_lastSample) {
+        m_cpuUsage = static_cast<int> ((cpuTime - m_cpuTime) * 100
+                                       / (now - m_lastSample));
+    }
+
+    m_memory = memory;
+    m_cpuTime = cpuTime;
+    m_lastSample = now;
+
+    emit usageChanged (m_cpuUsage, m_memory);
+
+    if (m_status != Starting)
+        return;
+
+    /* A Dashboard that cannot be probed is ready when it stops loading */
+    if (m_cpuUsage >= 0 && m_cpuUsage < _IDLE_CPU_USAGE)
+        ++m_idleSamples;
+    else
+        m_idleSamples = 0;
+
+    if (isConnected() || m_idleSamples >= _IDLE_SAMPLES) {
+        m_readyTime = now;
+        setStatus (Ready);
+
+        DriverStation::getInstance()->consoleStore()->append (
+            tr ("INFO: Dashboard ready after %1 ms").arg (readyTime()));
+    }
+
+    /* The process cannot be probed here (e.g. on Mac OS X) or never settles */
+    else if (now - m_startTime >= _READY_TIMEOUT) {
+        setStatus (AssumedReady);
+
+        DriverStation::getInstance()->consoleStore()->append (
+            tr ("INFO: Dashboard assumed ready after %1 ms")
+            .arg (now - m_startTime));
+    }
+}
+
+QString Dashboard::getCommand (int dashboard)
+{
+    QString path;
+
+    switch (dashboard) {
     case SfxDashboard:
         path = QString ("java -jar \"%1/wpilib/tools/%2/sfx.jar\"")
                .arg (QDir::homePath());
@@ -88,24 +321,86 @@ void Dashboard::loadDashboard()
 #endif
     }
 
-    m_process->start (path);
+    return path;
 }
 
-void Dashboard::quitDashboard()
+bool Dashboard::isConnected()
 {
-    m_process->close();
+#if defined __gnu_linux__
+    /* Get the inodes of the sockets owned by the process */
+    QList<QByteArray> inodes;
+    QString fdPath = QString ("/proc/%1/fd").arg (m_process->processId());
+    QDir::Filters filters = QDir::AllEntries | QDir::System
+                            | QDir::NoDotAndDotDot;
+
+    /* Socket links are dangling, they are only listed with QDir::System */
+    foreach (QString fd, QDir (fdPath).entryList (filters)) {
+        QByteArray link = QFile::symLinkTarget (fdPath + "/" + fd).toUtf8();
+        if (link.startsWith ("socket:["))
+            inodes.append (link.mid (8, link.indexOf (']') - 8));
+    }
+
+    /* Find an established (01) socket connected to the NetworkTables port */
+    QStringList tables;
+    tables.append (QString ("/proc/%1/net/tcp").arg (m_process->processId()));
+    tables.append (QString ("/proc/%1/net/tcp6").arg (m_process->processId()));
+
+    /* Addresses are written as hexadecimal values, such as 0100007F:06C7 */
+    QByteArray port = ":" + QByteArray::number (_NT_PORT, 16)
+                      .rightJustified (4, '0').toUpper();
+
+    foreach (QString table, tables) {
+        QFile file (table);
+        if (inodes.isEmpty() || !file.open (QFile::ReadOnly))
+            continue;
+
+        foreach (QByteArray line, file.readAll().split ('\n')) {
+            QList<QByteArray> fields = line.simplified().split (' ');
+            if (fields.count() > 9 && fields.at (2).endsWith (port)
+                    && fields.at (3) == "01" && inodes.contains (fields.at (9)))
+                return true;
+        }
+    }
+#endif
+
+    return false;
 }
 
-void Dashboard::reloadDashboard()
+void Dashboard::setStatus (Status status)
 {
-    quitDashboard();
-    loadDashboard();
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged (m_status);
+    }
 }
 
 //------------------------------------------------------------------------------
 // Dashboard-information functions (getters)
 //------------------------------------------------------------------------------
 
+int Dashboard::status()
+{
+    return m_status;
+}
+
+int Dashboard::cpuUsage()
+{
+    return m_cpuUsage;
+}
+
+qint64 Dashboard::residentMemory()
+{
+    return m_memory;
+}
+
+qint64 Dashboard::readyTime()
+{
+    if (m_readyTime < 0)
+        return -1;
+
+    return m_readyTime - m_startTime;
+}
+
 int Dashboard::getCurrentDashboard()
 {
     return m_current;
@@ -27,6 +27,7 @@
 #include <QApplication>
 
 #include <math.h>
+#include <DriverStation.h>
 
 #include "Settings.h"
 #include "GamepadManager.h"
@@ -70,26 +71,14 @@ GamepadManager::GamepadManager()
     SDL_JoystickEventState (SDL_ENABLE);
     SDL_GameControllerEventState (SDL_ENABLE);
 
-    /* Load community controller database */
-    QFile db (_CONTROLLER_DB);
-    if (db.open (QFile::ReadOnly)) {
-        while (!db.atEnd())
-            SDL_GameControllerAddMapping (
-                QVariant (db.readLine()).toString().toStdString().c_str());
-
-        db.close();
-    }
-
-    /* Load generic mapping string, used for unsupported controllers */
-    QFile generic (_GENERIC_MAPPINGS);
-    if (generic.open (QFile::ReadOnly)) {
-        m_genericMapping = (QString)generic.readAll();
-        generic.close();
-    }
+    m_time = 20;
+    m_tracker = -1;
 }
 
 GamepadManager::~GamepadManager()
 {
+    closeHandles();
+
     for (int i = 0; i < SDL_NumJoysticks(); i++)
         SDL_GameControllerClose (SDL_GameControllerOpen (i));
 
@@ -148,14 +137,76 @@ QStringList GamepadManager::joystickList()
     return list;
 }
 
+QString GamepadManager::getGuid (int joystick)
+{
+    char guid[64];
+    SDL_JoystickGetGUIDString (SDL_JoystickGetDeviceGUID (joystick),
+                               guid,
+                               sizeof (guid));
+
+    return QString (guid);
+}
+
+GM_State GamepadManager::getState (int joystick)
+{
+    if (!m_states.contains (joystick))
+        updateState (joystick);
+
+    return m_states.value (joystick);
+}
+
+AC_Config GamepadManager::getAxisConfig (int joystick, int axis)
+{
+    getHandle (joystick);
+    return m_conditioners[joystick].config (axis);
+}
+
+void GamepadManager::setAxisConfig (int joystick, int axis, AC_Config config)
+{
+    getHandle (joystick);
+    m_conditioners[joystick].setConfig (axis, config);
+
+    /* Other joysticks of the same model use the new settings too */
+    QString guid = getGuid (joystick);
+    foreach (int id, m_conditioners.keys()) {
+        if (id != joystick && getGuid (id) == guid)
+            m_conditioners[id].load (guid, getNumAxes (id));
+    }
+
+    if (updateState (joystick))
+        emit stateChanged();
+}
+
+void GamepadManager::setHysteresis (int joystick, double hysteresis)
+{
+    getHandle (joystick);
+    m_conditioners[joystick].setHysteresis (hysteresis);
+}
+
 //------------------------------------------------------------------------------
 // Functions that need to be called after initalization of UI
 //------------------------------------------------------------------------------
 
 void GamepadManager::init()
 {
-    m_time = 20;
-    m_tracker = -1;
+    /* Load community controller database */
+    QFile db (_CONTROLLER_DB);
+    if (db.open (QFile::ReadOnly)) {
+        while (!db.atEnd())
+            SDL_GameControllerAddMapping (
+                QVariant (db.readLine()).toString().toStdString().c_str());
+
+        db.close();
+    }
+
+    /* Load generic mapping string, used for unsupported controllers */
+    QFile generic (_GENERIC_MAPPINGS);
+    if (generic.open (QFile::ReadOnly)) {
+        m_genericMapping = (QString)generic.readAll();
+        generic.close();
+    }
+
+    DS_Profiler::getInstance()->timerScheduled ("SDL events", 500);
     QTimer::singleShot (500, this, SLOT (readSdlEvents()));
 }
 
@@ -224,6 +275,105 @@ GM_Joystick GamepadManager::getJoystick (const SDL_Event* event)
 // SDL magic
 //------------------------------------------------------------------------------
 
+SDL_Joystick* GamepadManager::getHandle (int joystick)
+{
+    if (!m_handles.contains (joystick)) {
+        SDL_Joystick* js = SDL_JoystickOpen (joystick);
+        m_handles.insert (joystick, js);
+
+        /* Load the conditioning settings of the joystick model */
+        AxisConditioner conditioner;
+        if (js != nullptr)
+            conditioner.load (getGuid (joystick), SDL_JoystickNumAxes (js));
+
+        m_conditioners.insert (joystick, conditioner);
+    }
+
+    return m_handles.value (joystick);
+}
+
+void GamepadManager::closeHandles()
+{
+    foreach (SDL_Joystick* js, m_handles) {
+        if (js != nullptr)
+            SDL_JoystickClose (js);
+    }
+
+    m_states.clear();
+    m_handles.clear();
+    m_conditioners.clear();
+}
+
+bool GamepadManager::updateState (int joystick)
+{
+    GM_State state;
+    state.id = joystick;
+
+    SDL_Joystick* js = getHandle (joystick);
+    if (js == nullptr) {
+        m_states.insert (joystick, state);
+        return false;
+    }
+
+    /* Condition all the axes of the joystick in a single pass */
+    int numAxes = SDL_JoystickNumAxes (js);
+    QVector<double> raw (numAxes);
+    QVector<double> axes (numAxes);
+    for (int i = 0; i < numAxes; i++)
+        raw[i] = (double) SDL_JoystickGetAxis (js, i) / _MAX_VAL;
+
+    bool changed = m_conditioners[joystick].process (raw.constData(),
+                                                     axes.data(),
+                                                     numAxes);
+
+    state.axes = axes.toList();
+
+    for (int i = 0; i < SDL_JoystickNumButtons (js); i++)
+        state.buttons.append (SDL_JoystickGetButton (js, i) == 1);
+
+    /* Convert the SDL hat positions to FRC-like POV angles */
+    for (int i = 0; i < SDL_JoystickNumHats (js); i++) {
+        switch (SDL_JoystickGetHat (js, i)) {
+        case SDL_HAT_UP:
+            state.povs.append (0);
+            break;
+        case SDL_HAT_RIGHTUP:
+            state.povs.append (45);
+            break;
+        case SDL_HAT_RIGHT:
+            state.povs.append (90);
+            break;
+        case SDL_HAT_RIGHTDOWN:
+            state.povs.append (135);
+            break;
+        case SDL_HAT_DOWN:
+            state.povs.append (180);
+            break;
+        case SDL_HAT_LEFTDOWN:
+            state.povs.append (225);
+            break;
+        case SDL_HAT_LEFT:
+            state.povs.append (270);
+            break;
+        case SDL_HAT_LEFTUP:
+            state.povs.append (315);
+            break;
+        default:
+            state.povs.append (-1);
+            break;
+        }
+    }
+
+    /* Axes are compared by the conditioner, which filters their noise */
+    GM_State last = m_states.value (joystick);
+    changed |= !m_states.contains (joystick)
+               || state.buttons != last.buttons
+               || state.povs != last.povs;
+
+    m_states.insert (joystick, state);
+    return changed;
+}
+
 int GamepadManager::getDynamicId (int id)
 {
     id = m_tracker - (id + 1);
@@ -235,32 +385,59 @@ int GamepadManager::getDynamicId (int id)
 
 void GamepadManager::readSdlEvents()
 {
+    DS_Profiler::getInstance()->timerFired ("SDL events");
+
+    bool input = false;
+
     SDL_Event event;
     while (SDL_PollEvent (&event)) {
         switch (event.type) {
         case SDL_CONTROLLERDEVICEADDED:
+            closeHandles();
             m_tracker += 1;
             onControllerAdded (&event);
             emit countChanged (joystickList());
             emit countChanged (SDL_NumJoysticks());
             break;
         case SDL_CONTROLLERDEVICEREMOVED:
+            closeHandles();
             onControllerRemoved (&event);
             emit countChanged (joystickList());
             emit countChanged (SDL_NumJoysticks());
             break;
         case SDL_CONTROLLERAXISMOTION:
+            input = true;
             onAxisEvent (&event);
             break;
         case SDL_CONTROLLERBUTTONDOWN:
+            input = true;
             onButtonEvent (&event);
             break;
         case SDL_CONTROLLERBUTTONUP:
+            input = true;
             onButtonEvent (&event);
             break;
+        case SDL_JOYAXISMOTION:
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+        case SDL_JOYHATMOTION:
+            input = true;
+            break;
         }
     }
 
+    /* Only notify the widgets if the conditioned state really changed */
+    bool changed = false;
+    if (input) {
+        for (int i = 0; i < SDL_NumJoysticks(); i++)
+            changed |= updateState (i);
+    }
+
+    /* Notify the widgets once, no matter how many events we read */
+    if (changed)
+        emit stateChanged();
+
+    DS_Profiler::getInstance()->timerScheduled ("SDL events", m_time);
     QTimer::singleShot (m_time, this, SLOT (readSdlEvents()));
 }
 
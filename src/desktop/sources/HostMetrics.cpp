@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QCoreApplication>
+
+#include "CpuUsage.h"
+#include "HostMetrics.h"
+
+#if defined _WIN32 || defined _WIN64
+#include <windows.h>
+#endif
+
+#if defined __APPLE__
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#endif
+
+#if defined __gnu_linux__
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Procfs files are kept open and re-read from the beginning on each sample */
+static int memFile = -1;
+static int netFile = -1;
+static int wirelessFile = -1;
+static char procBuffer[16384];
+
+/* Re-reads the given procfs file into the shared buffer */
+static bool readProcFile (int* file, const char* path)
+{
+    if (*file < 0)
+        *file = open (path, O_RDONLY | O_CLOEXEC);
+
+    if (*file < 0)
+        return false;
+
+    ssize_t length = pread (*file, procBuffer, sizeof (procBuffer) - 1, 0);
+    if (length <= 0)
+        return false;
+
+    procBuffer[length] = 0;
+    return true;
+}
+
+/* Returns the value (in kB) of the given /proc/meminfo key */
+static quint64 memInfoValue (const char* key)
+{
+    const char* line = strstr (procBuffer, key);
+    if (line == nullptr)
+        return 0;
+
+    return strtoull (line + strlen (key), nullptr, 10);
+}
+#endif
+
+/* Default number of milliseconds between each sample */
+#define _DEFAULT_INTERVAL 1000
+
+/* The timeline file is rotated when it grows beyond this size */
+#define _MAX_TIMELINE_SIZE (1024 * 1024)
+
+HostMetrics* HostMetrics::m_instance = nullptr;
+
+HostMetrics::HostMetrics()
+{
+    m_timeline.store (0);
+    m_interval.store (_DEFAULT_INTERVAL);
+
+    m_snapshot.timestamp = 0;
+    m_snapshot.cpuUsage = 0;
+    m_snapshot.memoryUsed = 0;
+    m_snapshot.memoryTotal = 0;
+    m_snapshot.battery.plugged = true;
+    m_snapshot.battery.discharging = false;
+    m_snapshot.battery.level = 0;
+    m_snapshot.battery.power = -1;
+    m_snapshot.battery.timeToEmpty = -1;
+    m_snapshot.link = DriverStation::getInstance()->robotLink()->stats();
+
+    qRegisterMetaType<HM_Snapshot> ("HM_Snapshot");
+
+    /* Probe the operating system outside of the GUI thread */
+    m_thread = new QThread();
+    moveToThread (m_thread);
+    connect (QCoreApplication::instance(), SIGNAL (aboutToQuit()),
+             m_thread,                     SLOT   (quit()));
+
+    m_thread->start (QThread::LowPriority);
+}
+
+HostMetrics* HostMetrics::getInstance()
+{
+    if (m_instance == nullptr)
+        m_instance = new HostMetrics();
+
+    return m_instance;
+}
+
+HM_Snapshot HostMetrics::snapshot()
+{
+    QMutexLocker locker (&m_mutex);
+    return m_snapshot;
+}
+
+int HostMetrics::interval()
+{
+    return m_interval.load();
+}
+
+QString HostMetrics::timelineFile()
+{
+    return QString ("%1/.qdriverstation/network.csv").arg (QDir::homePath());
+}
+
+void HostMetrics::init()
+{
+    sample();
+}
+
+void HostMetrics::setInterval (int interval)
+{
+    if (interval > 0)
+        m_interval.store (interval);
+}
+
+void HostMetrics::setTimelineEnabled (bool enabled)
+{
+    m_timeline.store (enabled ? 1 : 0);
+}
+
+void HostMetrics::sample()
+{
+    HM_Snapshot snapshot;
+    snapshot.timestamp = QDateTime::currentMSecsSinceEpoch();
+    snapshot.cpuUsage = qBound (0, CpuUsage::getUsage(), 100);
+    snapshot.coreUsage = CpuUsage::getCoreUsage();
+    snapshot.battery = Battery::readStatus();
+    snapshot.battery.level = qBound (0, snapshot.battery.level, 100);
+
+    snapshot.link = DriverStation::getInstance()->robotLink()->stats();
+
+    readMemory (&snapshot);
+    readInterfaces (&snapshot);
+
+    if (m_timeline.load())
+        writeTimeline (snapshot);
+    else if (m_file.isOpen())
+        m_file.close();
+
+    /* Only this thread writes the snapshot, readers just copy it */
+    m_mutex.lock();
+    m_snapshot = snapshot;
+    m_mutex.unlock();
+
+    emit snapshotChanged (snapshot);
+    QTimer::singleShot (m_interval.load(), this, SLOT (sample()));
+}
+
+void HostMetrics::readMemory (HM_Snapshot* snapshot)
+{
+    snapshot->memoryUsed = 0;
+    snapshot->memoryTotal = 0;
+
+#if defined _WIN32 || defined _WIN64
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof (status);
+
+    if (GlobalMemoryStatusEx (&status)) {
+        quint64 used = status.ullTotalPhys - status.ullAvailPhys;
+        snapshot->memoryTotal = status.ullTotalPhys / 1024;
+        snapshot->memoryUsed = used / 1024;
+    }
+#endif
+
+#if defined __APPLE__
+    quint64 memory = 0;
+    size_t length = sizeof (memory);
+
+    if (sysctlbyname ("hw.memsize", &memory, &length, nullptr, 0) == 0)
+        snapshot->memoryTotal = memory / 1024;
+#endif
+
+#if defined __gnu_linux__
+    if (readProcFile (&memFile, "/proc/meminfo")) {
+        quint64 available = memInfoValue ("MemAvailable:");
+        snapshot->memoryTotal = memInfoValue ("MemTotal:");
+
+        if (available <= snapshot->memoryTotal)
+            snapshot->memoryUsed = snapshot->memoryTotal - available;
+    }
+#endif
+}
+
+void HostMetrics::readInterfaces (HM_Snapshot* snapshot)
+{
+#if defined __gnu_linux__
+    if (!readProcFile (&netFile, "/proc/net/dev"))
+        return;
+
+    qint64 elapsed = snapshot->timestamp - m_snapshot.timestamp;
+
+    /* The first two lines are the column headers */
+    char* line = strchr (procBuffer, '\n');
+    if (line != nullptr)
+        line = strchr (line + 1, '\n');
+
+    while (line != nullptr && *(++line) != 0) {
+        char* colon = strchr (line, ':');
+        if (colon == nullptr)
+            break;
+
+        while (*line == ' ')
+            ++line;
+
+        /* bytes packets errs drop fifo frame compressed multicast (RX/TX) */
+        char* cursor = colon + 1;
+        quint64 fields[16] = {0};
+        for (int i = 0; i < 16; ++i)
+            fields[i] = strtoull (cursor, &cursor, 10);
+
+        HM_Interface entry;
+        entry.name = QString::fromLatin1 (line, colon - line);
+        entry.rxBytes = fields[0];
+        entry.rxPackets = fields[1];
+        entry.rxErrors = fields[2];
+        entry.rxDrops = fields[3];
+        entry.txBytes = fields[8];
+        entry.txPackets = fields[9];
+        entry.txErrors = fields[10];
+        entry.txDrops = fields[11];
+        entry.rxRate = 0;
+        entry.txRate = 0;
+        entry.retries = -1;
+        entry.linkQuality = -1;
+        entry.signalLevel = 0;
+
+        /* Calculate the rates with the counters of the previous snapshot */
+        for (int i = 0; i < m_snapshot.interfaces.count(); ++i) {
+            const HM_Interface& previous = m_snapshot.interfaces.at (i);
+            if (previous.name != entry.name || elapsed <= 0)
+                continue;
+
+            if (entry.rxBytes >= previous.rxBytes)
+                entry.rxRate = (entry.rxBytes - previous.rxBytes)
+                               * 1000 / elapsed;
+            if (entry.txBytes >= previous.txBytes)
+                entry.txRate = (entry.txBytes - previous.txBytes)
+                               * 1000 / elapsed;
+
+            break;
+        }
+
+        snapshot->interfaces.append (entry);
+        line = strchr (cursor, '\n');
+    }
+
+    /*
+     * The wireless statistics (the same values found in the 'wireless'
+     * directory of each interface in sysfs) are all in a single file:
+     * status link level noise nwid crypt frag retry misc beacon
+     */
+    if (!readProcFile (&wirelessFile, "/proc/net/wireless"))
+        return;
+
+    line = strchr (procBuffer, '\n');
+    if (line != nullptr)
+        line = strchr (line + 1, '\n');
+
+    while (line != nullptr && *(++line) != 0) {
+        char* colon = strchr (line, ':');
+        if (colon == nullptr)
+            break;
+
+        while (*line == ' ')
+            ++line;
+
+        /* Values may be followed by a '.' when they have been updated */
+        char* cursor = colon + 1;
+        qint64 fields[8] = {0};
+        strtoul (cursor, &cursor, 16);
+        for (int i = 0; i < 8; ++i) {
+            fields[i] = strtoll (cursor, &cursor, 10);
+            if (*cursor == '.')
+                ++cursor;
+        }
+
+        QString name = QString::fromLatin1 (line, colon - line);
+        for (int i = 0; i < snapshot->interfaces.count(); ++i) {
+            HM_Interface& entry = snapshot->interfaces[i];
+            if (entry.name == name) {
+                entry.linkQuality = static_cast<int> (fields[0]);
+                entry.signalLevel = static_cast<int> (fields[1]);
+                entry.retries = fields[6];
+                break;
+            }
+        }
+
+        line = strchr (cursor, '\n');
+    }
+#else
+    Q_UNUSED (snapshot);
+#endif
+}
+
+bool HostMetrics::openTimeline()
+{
+    if (m_file.isOpen())
+        return true;
+
+    m_file.setFileName (timelineFile());
+    QDir().mkpath (QFileInfo (m_file).absolutePath());
+
+    bool header = !m_file.exists() || m_file.size() == 0;
+    if (!m_file.open (QFile::Append | QFile::Text))
+        return false;
+
+    if (header)
+        m_file.write ("time,interface,rx_bytes,tx_bytes,rx_packets,tx_packets,"
+                      "rx_errors,tx_errors,rx_drops,tx_drops,retries,"
+                      "link_quality,signal_level,ds_sent,ds_received,ds_lost,"
+                      "ds_loss_rate,ds_latency,ds_max_latency\n");
+
+    return true;
+}
+
+void HostMetrics::writeTimeline (const HM_Snapshot& snapshot)
+{
+    if (m_file.isOpen() && m_file.size() > _MAX_TIMELINE_SIZE) {
+        m_file.close();
+        QFile::remove (timelineFile() + ".1");
+        QFile::rename (timelineFile(), timelineFile() + ".1");
+    }
+
+    if (!openTimeline())
+        return;
+
+    QTextStream stream (&m_file);
+
+    /* The DS counters are repeated so that each line stands on its own */
+    QString link = QString ("%1,%2,%3,%4,%5,%6")
+                   .arg (snapshot.link.sent)
+                   .arg (snapshot.link.received)
+                   .arg (snapshot.link.lost)
+                   .arg (snapshot.link.lossRate)
+                   .arg (snapshot.link.latency)
+                   .arg (snapshot.link.maxLatency);
+
+    foreach (HM_Interface entry, snapshot.interfaces) {
+        if (entry.name == "lo")
+            continue;
+
+        stream << snapshot.timestamp << ","
+               << entry.name << ","
+               << entry.rxBytes << ","
+               << entry.txBytes << ","
+               << entry.rxPackets << ","
+               << entry.txPackets << ","
+               << entry.rxErrors << ","
+               << entry.txErrors << ","
+               << entry.rxDrops << ","
+               << entry.txDrops << ","
+               << entry.retries << ","
+               << entry.linkQuality << ","
+               << entry.signalLevel << ","
+               << link << "\n";
+    }
+
+    /* Do not lose the last samples if the application crashes */
+    stream.flush();
+    m_file.flush();
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtMath>
+#include <QPainter>
+
+#include "JoystickView.h"
+
+/* Size of each axis indicator */
+#define _AXIS_WIDTH 160
+#define _AXIS_HEIGHT 19
+
+/* Size of each button indicator, buttons are drawn in columns of eight */
+#define _BUTTON_WIDTH 18
+#define _BUTTON_HEIGHT 12
+#define _BUTTONS_PER_COLUMN 8
+
+/* Diameter of each POV indicator */
+#define _POV_SIZE 38
+
+/* Space between the indicators and between each group of indicators */
+#define _SPACING 1
+#define _GROUP_SPACING 8
+
+/* Colors used by the indicators, same as the old push buttons */
+#define _IDLE_COLOR QColor (38, 38, 38)
+#define _ACTIVE_COLOR QColor (33, 255, 43)
+
+JoystickView::JoystickView (QWidget* parent) : QWidget (parent)
+{
+    m_valid = false;
+    m_state.id = -1;
+}
+
+QSize JoystickView::sizeHint() const
+{
+    if (!m_valid)
+        return QSize (0, 0);
+
+    int width = povsOffset();
+    if (m_state.povs.count() > 0)
+        width += _POV_SIZE;
+
+    int axesHeight = m_state.axes.count() * (_AXIS_HEIGHT + _SPACING);
+    int povsHeight = m_state.povs.count() * (_POV_SIZE + _SPACING);
+    int buttonsHeight = qMin (m_state.buttons.count(), _BUTTONS_PER_COLUMN)
+                        * (_BUTTON_HEIGHT + _SPACING);
+
+    return QSize (width, qMax (axesHeight, qMax (buttonsHeight, povsHeight)));
+}
+
+QSize JoystickView::minimumSizeHint() const
+{
+    return sizeHint();
+}
+
+void JoystickView::setState (const GM_State& state)
+{
+    if (m_valid
+            && state.id == m_state.id
+            && state.axes == m_state.axes
+            && state.buttons == m_state.buttons
+            && state.povs == m_state.povs)
+        return;
+
+    /* Only re-calculate the layout if the joystick has changed */
+    bool resize = !m_valid
+                  || state.axes.count() != m_state.axes.count()
+                  || state.buttons.count() != m_state.buttons.count()
+                  || state.povs.count() != m_state.povs.count();
+
+    m_state = state;
+    m_valid = true;
+
+    if (resize)
+        updateGeometry();
+
+    update();
+}
+
+void JoystickView::clear()
+{
+    if (m_valid) {
+        m_valid = false;
+        m_state = GM_State();
+        m_state.id = -1;
+
+        updateGeometry();
+        update();
+    }
+}
+
+void JoystickView::paintEvent (QPaintEvent* event)
+{
+    Q_UNUSED (event);
+
+    if (!m_valid)
+        return;
+
+    QPainter painter (this);
+
+    /* Draw each axis as a bar that grows from its center */
+    for (int i = 0; i < m_state.axes.count(); ++i) {
+        QRect rect (0, i * (_AXIS_HEIGHT + _SPACING),
+                    _AXIS_WIDTH, _AXIS_HEIGHT);
+
+        double value = qBound (-1.0, m_state.axes.at (i), 1.0);
+        int center = rect.left() + rect.width() / 2;
+        int length = qRound (value * rect.width() / 2);
+
+        painter.fillRect (rect, _IDLE_COLOR);
+        painter.fillRect (QRect (qMin (center, center + length), rect.top(),
+                                 qAbs (length), rect.height()),
+                          palette().highlight());
+
+        painter.setPen (palette().color (QPalette::HighlightedText));
+        painter.drawText (rect, Qt::AlignCenter, tr ("Axis %1").arg (i));
+    }
+
+    /* Draw the buttons in columns of eight */
+    for (int i = 0; i < m_state.buttons.count(); ++i) {
+        int row = i % _BUTTONS_PER_COLUMN;
+        int column = i / _BUTTONS_PER_COLUMN;
+
+        QRect rect (buttonsOffset() + column * (_BUTTON_WIDTH + _SPACING),
+                    row * (_BUTTON_HEIGHT + _SPACING),
+                    _BUTTON_WIDTH, _BUTTON_HEIGHT);
+
+        painter.fillRect (rect, m_state.buttons.at (i) ? _ACTIVE_COLOR :
+                          _IDLE_COLOR);
+    }
+
+    /* Draw each POV as a circle with a dot pointing to its angle */
+    painter.setRenderHint (QPainter::Antialiasing);
+    for (int i = 0; i < m_state.povs.count(); ++i) {
+        QRectF rect (povsOffset(), i * (_POV_SIZE + _SPACING),
+                     _POV_SIZE - 1, _POV_SIZE - 1);
+
+        painter.setPen (Qt::NoPen);
+        painter.setBrush (_IDLE_COLOR);
+        painter.drawEllipse (rect);
+
+        int angle = m_state.povs.at (i);
+        if (angle >= 0) {
+            qreal radius = rect.width() / 2 - 6;
+            qreal radians = qDegreesToRadians ((qreal) angle);
+            QPointF dot (rect.center().x() + radius * qSin (radians),
+                         rect.center().y() - radius * qCos (radians));
+
+            painter.setBrush (_ACTIVE_COLOR);
+            painter.drawEllipse (dot, 4, 4);
+        }
+    }
+}
+
+int JoystickView::buttonColumns() const
+{
+    return (m_state.buttons.count() + _BUTTONS_PER_COLUMN - 1)
+           / _BUTTONS_PER_COLUMN;
+}
+
+int JoystickView::buttonsOffset() const
+{
+    if (m_state.axes.isEmpty())
+        return 0;
+
+    return _AXIS_WIDTH + _GROUP_SPACING;
+}
+
+int JoystickView::povsOffset() const
+{
+    int offset = buttonsOffset();
+
+    if (buttonColumns() > 0)
+        offset += buttonColumns() * (_BUTTON_WIDTH + _SPACING)
+                  + _GROUP_SPACING;
+
+    return offset;
+}
@@ -20,12 +20,13 @@
  * THE SOFTWARE.
  */
 
-#include <QPointer>
-#include <QPushButton>
-#include <QProgressBar>
-#include <qdebug.h>
+#include <QTimer>
 
 #include "Joysticks.h"
+#include "JoystickView.h"
+
+/* Milliseconds between each frame (about 60 frames per second) */
+#define _FRAME_INTERVAL 16
 
 //------------------------------------------------------------------------------
 // Class initalization functions
@@ -34,17 +35,18 @@
 Joysticks::Joysticks (QWidget* parent) : QWidget (parent)
 {
     ui.setupUi (this);
-    ui.Axes->setVisible (false);
+    ui.Input->setVisible (false);
     ui.Rumble->setVisible (false);
-    ui.Buttons->setVisible (false);
     ui.Rumble->setMinimumWidth (ui.JoystickList->width());
 
+    m_refreshPending = false;
+    m_view = new JoystickView (this);
+    ui.InputLayout->insertWidget (0, m_view);
+
     m_manager = GamepadManager::getInstance();
 
-    connect (m_manager, SIGNAL (axisEvent (GM_Axis)),
-             this,      SLOT   (onAxisEvent (GM_Axis)));
-    connect (m_manager, SIGNAL (buttonEvent (GM_Button)),
-             this,      SLOT   (onButtonEvent (GM_Button)));
+    connect (m_manager, SIGNAL (stateChanged()),
+             this,      SLOT   (onStateChanged()));
     connect (m_manager, SIGNAL (countChanged (QStringList)),
              this,      SLOT   (onCountChanged (QStringList)));
     connect (ui.Rumble, SIGNAL (clicked()),
@@ -53,6 +55,12 @@ Joysticks::Joysticks (QWidget* parent) : QWidget (parent)
              this,            SLOT   (onRowChanged (int)));
 }
 
+void Joysticks::showEvent (QShowEvent* event)
+{
+    QWidget::showEvent (event);
+    refreshView();
+}
+
 //------------------------------------------------------------------------------
 // Functions that react to UI events
 //------------------------------------------------------------------------------
@@ -64,69 +72,8 @@ void Joysticks::onRumbleClicked()
 
 void Joysticks::onRowChanged (int row)
 {
-    /* Remove all buttons and progress bars in the widget */
-    foreach (QPushButton* c, findChildren<QPushButton*>())
-        delete c;
-    foreach (QProgressBar* p, findChildren<QProgressBar*>())
-        delete p;
-
-    /* Clear joystick data */
-    m_axes.clear();
-    m_buttons.clear();
-    ui.Axes->setVisible (false);
-    ui.Buttons->setVisible (false);
-
-    /* Avoid crashing the application when there are no joysticks */
-    if (row < 0)
-        return;
-
-    /* Get joystick information */
-    int axisCount = m_manager->getNumAxes (row);
-    int buttonCount = m_manager->getNumButtons (row);
-
-    ui.Axes->setVisible (axisCount > 0);
-    ui.Buttons->setVisible (buttonCount > 0);
-
-    /* Create a progress bar for each axis */
-    for (int i = 0; i < axisCount; i++) {
-        QPointer<QProgressBar> bar = new QProgressBar (this);
-
-        bar->setMaximumHeight (19);
-        bar->setMinimumHeight (19);
-
-        bar->setValue (0);
-        bar->setMaximum (100);
-        bar->setMinimum (-100);
-        bar->setFormat (m_manager->getAxisName (i));
-
-        m_axes.append (bar);
-        ui.AxesWidget->layout()->addWidget (bar);
-    }
-
-    /* Create a button for each joystick button */
-    for (int i = 0; i < buttonCount; i++) {
-        QPointer<QPushButton> button = new QPushButton (this);
-
-        button->setEnabled (false);
-        button->setCheckable (true);
-        button->setMaximumSize (18, 12);
-        button->setMinimumSize (18, 12);
-        button->setToolTip (m_manager->getButtonName (i));
-
-        int row = 0;
-        int column = 0;
-
-        if (i <= 7)
-            row = i;
-
-        else {
-            row = i - 8;
-            column = (int) (i / 8);
-        }
-
-        m_buttons.append (button);
-        ui.ButtonLayout->addWidget (button, row, column);
-    }
+    Q_UNUSED (row);
+    refreshView();
 }
 
 //------------------------------------------------------------------------------
@@ -159,36 +106,30 @@ void Joysticks::onCountChanged (QStringList list)
     emit statusChanged (list.count() > 0);
 }
 
-void Joysticks::onAxisEvent (GM_Axis axis)
+void Joysticks::onStateChanged()
 {
-    /*
-     * Only proceed if the joystick that emitted the signal is currently
-     * selected by the user
-     */
-    if (ui.JoystickList->currentRow() != axis.joystick.id)
-        return;
-
-    /*
-     * Only proceed if the reported axis exists.
-     * SDL may throw some crazy values when a joystick is attached or removed
-     */
-    if (axis.rawId < m_axes.count())
-        m_axes.at (axis.rawId)->setValue (axis.value * 100);
+    if (!m_refreshPending && isVisible()) {
+        m_refreshPending = true;
+        QTimer::singleShot (_FRAME_INTERVAL, this, SLOT (refreshView()));
+    }
 }
 
-void Joysticks::onButtonEvent (GM_Button button)
+void Joysticks::refreshView()
 {
-    /*
-     * Only proceed if the joystick that emitted the signal is currently
-     * selected by the user
-     */
-    if (ui.JoystickList->currentRow() != button.joystick.id)
+    m_refreshPending = false;
+
+    /* Avoid crashing the application when there are no joysticks */
+    int row = ui.JoystickList->currentRow();
+    if (row < 0) {
+        m_view->clear();
+        ui.Input->setVisible (false);
         return;
+    }
 
-    /*
-     * Only proceed if the reported button exists.
-     * SDL may throw some crazy values when a joystick is attached or removed
-     */
-    if (button.rawId < m_buttons.count())
-        m_buttons.at (button.rawId)->setChecked (button.pressed);
+    GM_State state = m_manager->getState (row);
+    ui.Input->setVisible (!state.axes.isEmpty()
+                          || !state.buttons.isEmpty()
+                          || !state.povs.isEmpty());
+
+    m_view->setState (state);
 }
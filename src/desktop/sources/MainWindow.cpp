@@ -22,24 +22,33 @@
 
 #include "MainWindow.h"
 
+#include <QDir>
 #include <QList>
 #include <QTimer>
 #include <QColor>
 #include <QPalette>
 #include <QPointer>
+#include <QScrollBar>
 #include <QClipboard>
+#include <QFileDialog>
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QDesktopServices>
+#include <QtAlgorithms>
 
 #include <DriverStation.h>
 
-#include "Battery.h"
+#include "Charts.h"
+#include "Startup.h"
 #include "Settings.h"
-#include "CpuUsage.h"
 #include "Dashboard.h"
 #include "Joysticks.h"
 #include "InitTasks.h"
+#include "HostMetrics.h"
+#include "Performance.h"
+#include "TelemetryStore.h"
+#include "Watchdog.h"
+#include "WidgetUpdater.h"
 #include "AssemblyInfo.h"
 #include "AdvancedSettings.h"
 
@@ -48,6 +57,9 @@
 #define _DISABLED_SELECTED "color: rgb(255, 33, 43); border-left: 0px;"
 #define _DISABLED_NOT_SELECTED "color: rgb(43, 0, 0); border-left: 0px;"
 
+/* Time to wait after the last key press before filtering the NetConsole */
+#define _FILTER_DELAY 250
+
 #if defined __WIN32 || defined __WIN64
 #define _NETCONSOLE_FONT QFont ("Consolas", 10)
 #else
@@ -60,27 +72,53 @@
 
 MainWindow::MainWindow()
 {
+    Startup* startup = Startup::getInstance();
+
+    startup->beginPhase ("Main window");
     ui.setupUi (this);
+    m_network = false;
+    m_joystickCount = 0;
+    m_advancedSettings = nullptr;
+    m_ds = DriverStation::getInstance();
+    m_updater = new WidgetUpdater (this);
     setVisible (false);
     setUseFixedSize (true);
     setPromptOnQuit (true);
     setVisible (true);
 
-    connectSlots();
-    configureWidgetAppearance();
-
-    /* Perform first run tasks */
+    /* Start talking to the robot as soon as we know its address */
+    startup->beginPhase ("First run tasks");
     setTeamNumber (InitTasks::getTeamNumber());
     InitTasks::executeFirstRunTasks();
 
-    /* UI has finished loading, turn on the modules */
-    DriverStation::getInstance()->init();
-    GamepadManager::getInstance()->init();
+    startup->beginPhase ("Driver Station");
+    m_ds->setCustomAddress (Settings::get ("Custom Address", "").toString());
+    m_ds->rateController()->setBounds (
+        Settings::get ("Min Packet Interval", 10).toInt(),
+        Settings::get ("Max Packet Interval", 20).toInt());
+    connect (m_ds->robotLink(), SIGNAL (firstPacketSent()),
+             startup,           SLOT   (markFirstPacket()));
+    m_ds->init();
+
+    startup->beginPhase ("Widgets and signals");
+    connectSlots();
+    configureWidgetAppearance();
+
+    /* Start the other modules once the window is interactive */
+    startup->defer ("Joystick mappings", GamepadManager::getInstance(),
+                    "init", Startup::High);
+    startup->defer ("Stall watchdog", this, "startWatchdog", Startup::High);
+    startup->defer ("Host metrics", this, "startHostMetrics");
+    startup->defer ("Telemetry store", TelemetryStore::getInstance(), "init");
+    startup->defer ("Dashboard", Dashboard::getInstance(), "loadDashboard",
+                    Startup::Low);
+    startup->defer ("Advanced settings", this, "createAdvancedSettings",
+                    Startup::Low);
+    connect (startup, SIGNAL (finished()), this, SLOT (onStartupFinished()));
 }
 
 void MainWindow::connectSlots()
 {
-    updatePcStatusWidgets();
     connect (ui.Website,           SIGNAL (clicked()),
              this,                 SLOT   (onWebsiteClicked()));
     connect (ui.EnableButton,      SIGNAL (clicked()),
@@ -105,29 +143,36 @@ void MainWindow::connectSlots()
     connect (j, SIGNAL (statusChanged (bool)),
              ui.Joysticks, SLOT (setChecked (bool)));
 
+    /* Send the joystick states to the robot with each control packet */
+    GamepadManager* manager = GamepadManager::getInstance();
+    connect (manager, SIGNAL (stateChanged()),
+             this,    SLOT   (updateJoystickData()));
+    connect (manager, SIGNAL (countChanged (int)),
+             this,    SLOT   (onJoystickCountChanged (int)));
+
+    /* Charts */
+    ui.ChartsTab->layout()->addWidget (new Charts (ui.ChartsTab));
+
     /* DriverStation */
-    m_ds = DriverStation::getInstance();
     ui.StationCombo->addItems (m_ds->alliances());
-    connect (m_ds, SIGNAL (codeChanged (bool)),
-             this, SLOT   (onCodeChanged (bool)));
-    connect (m_ds, SIGNAL (networkChanged (bool)),
-             this, SLOT   (onNetworkChanged (bool)));
-    connect (m_ds, SIGNAL (radioChanged (bool)),
-             this, SLOT   (onRadioChanged (bool)));
-    connect (m_ds, SIGNAL (voltageChanged (float)),
-             this, SLOT   (onVoltageChanged (float)));
-    connect (m_ds, SIGNAL (libVersionChanged (QString)),
-             this, SLOT   (onLibVersionChanged (QString)));
-    connect (m_ds, SIGNAL (rioVersionChanged (QString)),
-             this, SLOT   (onRioVersionChanged (QString)));
-    connect (m_ds, SIGNAL (robotStatusChanged (QString)),
-             this, SLOT   (onRobotStatusChanged (QString)));
-    connect (m_ds, SIGNAL (ramUsageChanged (int, int)),
-             this, SLOT   (onRamUsageChanged (int, int)));
-    connect (m_ds, SIGNAL (diskUsageChanged (int, int)),
-             this, SLOT   (onDiskUsageChanged (int, int)));
-    connect (m_ds, SIGNAL (elapsedTimeChanged (QString)),
-             ui.ElapsedTime, SLOT (setText (QString)));
+    connect (m_ds, SIGNAL (stateChanged   (DS_State, int)),
+             this, SLOT   (onStateChanged (DS_State, int)));
+
+    /* Format the elapsed time only when the label can change */
+    m_clockTimer = new QTimer (this);
+    m_clockTimer->setInterval (100);
+    connect (m_clockTimer, SIGNAL (timeout()),
+             this,         SLOT   (updateElapsedTime()));
+
+    /* Update the status label when the user selects another mode */
+    connect (ui.Test,       SIGNAL (toggled (bool)),
+             this,          SLOT   (updateStatusLabel()));
+    connect (ui.TeleOp,     SIGNAL (toggled (bool)),
+             this,          SLOT   (updateStatusLabel()));
+    connect (ui.Practice,   SIGNAL (toggled (bool)),
+             this,          SLOT   (updateStatusLabel()));
+    connect (ui.Autonomous, SIGNAL (toggled (bool)),
+             this,          SLOT   (updateStatusLabel()));
 
     /* Dashboards */
     QPointer<Dashboard> dash = Dashboard::getInstance();
@@ -149,12 +194,16 @@ void MainWindow::connectSlots()
     connect (ui.PracticeAutonomous, SIGNAL (valueChanged (int)),
              this,                  SLOT   (onPracticeValuesChanged()));
 
-    /* Advanced settings window */
-    m_advancedSettings = new AdvancedSettings();
+    /* Advanced settings window, created after the startup */
     connect (ui.AdvancedSettings, SIGNAL (clicked()),
-             m_advancedSettings,  SLOT   (show()));
+             this,                SLOT   (showAdvancedSettings()));
     connect (ui.SettingsButton,   SIGNAL (clicked()),
-             m_advancedSettings,  SLOT   (show()));
+             this,                SLOT   (showAdvancedSettings()));
+
+    /* Performance diagnostics window */
+    m_performance = new Performance();
+    connect (ui.PerformanceButton, SIGNAL (clicked()),
+             m_performance,        SLOT   (show()));
 }
 
 void MainWindow::configureWidgetAppearance()
@@ -193,13 +242,39 @@ void MainWindow::configureWidgetAppearance()
                                   ui.DisableButton->height());
 
     /* Configure the NetConsole */
-    ui.NetConsoleEdit->setFont (_NETCONSOLE_FONT);
-    connect (m_ds->netConsole(),        SIGNAL (newMessage (QString)),
-             ui.NetConsoleEdit,         SLOT   (append (QString)));
-    connect (ui.ClearButton,            SIGNAL (clicked()),
-             ui.NetConsoleEdit,         SLOT   (clear()));
-    connect (ui.CopyButton,             SIGNAL (clicked()),
-             this,                      SLOT   (onCopyClicked()));
+    NetConsole* console = m_ds->netConsole();
+    console->setMessageBudget (Settings::get ("NetConsole Budget",
+                               console->messageBudget()).toInt());
+
+    DS_ConsoleStore* store = m_ds->consoleStore();
+    m_consoleFilter = new DS_ConsoleFilter (store, this);
+
+    /* Filter the history once the user stops typing, not on every key */
+    m_filterTimer = new QTimer (this);
+    m_filterTimer->setSingleShot (true);
+    m_filterTimer->setInterval (_FILTER_DELAY);
+
+    ui.ExportProgress->setVisible (false);
+    ui.NetConsoleView->setModel (m_consoleFilter);
+    ui.NetConsoleView->setFont (_NETCONSOLE_FONT);
+    ui.NetConsoleView->setLayoutMode (QListView::Batched);
+
+    connect (m_consoleFilter,   SIGNAL (rowsInserted (QModelIndex, int, int)),
+             this,              SLOT   (onConsoleRowsInserted()));
+    connect (ui.FilterEdit,     SIGNAL (textChanged (QString)),
+             m_filterTimer,     SLOT   (start()));
+    connect (m_filterTimer,     SIGNAL (timeout()),
+             this,              SLOT   (onFilterTimeout()));
+    connect (ui.ClearButton,    SIGNAL (clicked()),
+             store,             SLOT   (clear()));
+    connect (ui.CopyButton,     SIGNAL (clicked()),
+             this,              SLOT   (onCopyClicked()));
+    connect (ui.ExportButton,   SIGNAL (clicked()),
+             this,              SLOT   (onExportClicked()));
+    connect (store,             SIGNAL (exportProgress (int)),
+             ui.ExportProgress, SLOT   (setValue (int)));
+    connect (store,             SIGNAL (exportFinished (bool, QString)),
+             this,              SLOT   (onExportFinished (bool, QString)));
 }
 
 void MainWindow::readPracticeValues()
@@ -221,26 +296,33 @@ void MainWindow::readPracticeValues()
 // Functions that are called constantly with a timer
 //------------------------------------------------------------------------------
 
-void MainWindow::updatePcStatusWidgets()
+void MainWindow::updatePcStatusWidgets (HM_Snapshot snapshot)
 {
-    if (ui.LeftTab->currentIndex() == 0) {
-        int usage = CpuUsage::getUsage();
-        int level = Battery::currentLevel();
-
-        if (usage < 0 || usage > 100)
-            usage = 0;
-
-        if (level < 0 || level > 100)
-            level = 0;
-
-        ui.PcCpuProgress->setValue (usage);
-        ui.PcBatteryProgress->setValue (level);
-        ui.PlugIcon->setVisible (Battery::isPlugged());
-        ui.PcCpuProgress->setToolTip (tr ("CPU usage: %1%").arg (usage));
-        ui.PcBatteryProgress->setToolTip (tr ("Battery level: %1%").arg (level));
+    const Battery::Status& battery = snapshot.battery;
+    QString cpuTooltip = tr ("CPU usage: %1%").arg (snapshot.cpuUsage);
+    QString batteryTooltip = tr ("Battery level: %1%").arg (battery.level);
+
+    if (snapshot.memoryTotal > 0 && snapshot.memoryUsed > 0)
+        cpuTooltip.append ("\n" + tr ("Memory usage: %1 MB of %2 MB")
+                           .arg (snapshot.memoryUsed / 1024)
+                           .arg (snapshot.memoryTotal / 1024));
+
+    if (battery.power > 0)
+        batteryTooltip.append ("\n" + tr ("Power draw: %1 W")
+                               .arg (battery.power / 1000.0, 0, 'f', 1));
+
+    if (battery.timeToEmpty >= 0) {
+        int hours = battery.timeToEmpty / 60;
+        int minutes = battery.timeToEmpty % 60;
+        batteryTooltip.append ("\n" + tr ("Time remaining: %1:%2").arg (hours)
+                               .arg (minutes, 2, 10, QChar ('0')));
     }
 
-    QTimer::singleShot (500, this, SLOT (updatePcStatusWidgets()));
+    ui.PcCpuProgress->setValue (snapshot.cpuUsage);
+    ui.PcBatteryProgress->setValue (battery.level);
+    ui.PlugIcon->setVisible (battery.plugged);
+    ui.PcCpuProgress->setToolTip (cpuTooltip);
+    ui.PcBatteryProgress->setToolTip (batteryTooltip);
 }
 
 //------------------------------------------------------------------------------
@@ -249,10 +331,84 @@ void MainWindow::updatePcStatusWidgets()
 
 void MainWindow::onCopyClicked()
 {
-    qApp->clipboard()->setText (ui.NetConsoleEdit->toPlainText());
-    ui.NetConsoleEdit->append ("<font color=\"#aaa\"><p>"
-                               "INFO: NetConsole ouput copied to clipboard"
-                               "</p></font>");
+    QModelIndexList rows = ui.NetConsoleView->selectionModel()->selectedRows();
+
+    /* Nothing is selected, copy the messages that match the filter */
+    if (rows.isEmpty() && !m_consoleFilter->pattern().isEmpty()) {
+        for (int i = 0; i < m_consoleFilter->rowCount(); ++i)
+            rows.append (m_consoleFilter->index (i, 0));
+    }
+
+    /* Copying the whole history would freeze the UI, use the export instead */
+    if (rows.isEmpty()) {
+        m_ds->consoleStore()->append (tr ("INFO: Select or filter the messages "
+                                          "to copy, or export the NetConsole "
+                                          "to a file"));
+        return;
+    }
+
+    qSort (rows);
+
+    QStringList lines;
+    foreach (const QModelIndex& index, rows)
+        lines.append (index.data().toString());
+
+    qApp->clipboard()->setText (lines.join ("\n"));
+    m_ds->consoleStore()->append (tr ("INFO: %1 NetConsole messages copied to "
+                                      "clipboard").arg (lines.count()));
+}
+
+void MainWindow::onExportClicked()
+{
+    QString jsonFilter = tr ("JSON lines (*.jsonl)");
+    QString textFilter = tr ("Text files (*.txt)");
+
+    QString selectedFilter;
+    QString path = QFileDialog::getSaveFileName (this,
+                                                 tr ("Export NetConsole"),
+                                                 QDir::homePath(),
+                                                 textFilter + ";;" + jsonFilter,
+                                                 &selectedFilter);
+
+    if (path.isEmpty())
+        return;
+
+    DS_ConsoleStore::ExportFormat format = DS_ConsoleStore::PlainText;
+    if (selectedFilter == jsonFilter || path.endsWith (".jsonl"))
+        format = DS_ConsoleStore::JsonLines;
+
+    ui.ExportButton->setEnabled (false);
+    ui.ExportProgress->setValue (0);
+    ui.ExportProgress->setVisible (true);
+
+    m_ds->consoleStore()->exportToFile (path, format);
+}
+
+void MainWindow::onExportFinished (bool success, QString path)
+{
+    ui.ExportButton->setEnabled (true);
+    ui.ExportProgress->setVisible (false);
+
+    if (success)
+        m_ds->consoleStore()->append (tr ("INFO: NetConsole exported to %1")
+                                      .arg (path));
+    else
+        m_ds->consoleStore()->append (tr ("ERROR: Cannot write to %1")
+                                      .arg (path));
+}
+
+void MainWindow::onFilterTimeout()
+{
+    m_consoleFilter->setPattern (ui.FilterEdit->text());
+}
+
+void MainWindow::onConsoleRowsInserted()
+{
+    QScrollBar* bar = ui.NetConsoleView->verticalScrollBar();
+
+    /* Only follow the new messages if the user is not reading old ones */
+    if (bar->value() == bar->maximum())
+        ui.NetConsoleView->scrollToBottom();
 }
 
 void MainWindow::onRebootClicked()
@@ -304,6 +460,47 @@ void MainWindow::onJoystickRemoved()
         onDisabledClicked();
 }
 
+void MainWindow::onJoystickCountChanged (int count)
+{
+    m_joystickCount = count;
+    updateJoystickData();
+
+    /* The descriptors only change when a joystick is attached or removed */
+    GamepadManager* manager = GamepadManager::getInstance();
+
+    QList<DS_JoystickDescriptor> descriptors;
+    for (int i = 0; i < m_joystickCount; ++i) {
+        GM_State state = manager->getState (i);
+
+        DS_JoystickDescriptor descriptor;
+        descriptor.name = manager->getJoystickName (i);
+        descriptor.numAxes = state.axes.count();
+        descriptor.numButtons = state.buttons.count();
+        descriptor.numPovs = state.povs.count();
+        descriptors.append (descriptor);
+    }
+
+    m_ds->putJoystickDescriptors (descriptors);
+}
+
+void MainWindow::updateJoystickData()
+{
+    GamepadManager* manager = GamepadManager::getInstance();
+
+    QList<DS_JoystickData> joysticks;
+    for (int i = 0; i < m_joystickCount; ++i) {
+        GM_State state = manager->getState (i);
+
+        DS_JoystickData data;
+        data.axes = state.axes;
+        data.buttons = state.buttons;
+        data.povs = state.povs;
+        joysticks.append (data);
+    }
+
+    m_ds->putJoystickData (joysticks);
+}
+
 void MainWindow::onWindowModeChanged()
 {
     if (ui.WindowDocked->isChecked()) {
@@ -339,7 +536,54 @@ void MainWindow::setTeamNumber (int team)
     ui.TeamNumber->setText (QString ("%1").arg (team));
 
     m_ds->setTeamNumber (team);
-    m_advancedSettings->setTeamNumber (team);
+
+    if (m_advancedSettings != nullptr)
+        m_advancedSettings->setTeamNumber (team);
+}
+
+void MainWindow::createAdvancedSettings()
+{
+    if (m_advancedSettings == nullptr) {
+        m_advancedSettings = new AdvancedSettings();
+        m_advancedSettings->setTeamNumber (ui.TeamNumberSpin->value());
+    }
+}
+
+void MainWindow::startWatchdog()
+{
+    /* Watch the GUI thread for stalls that would delay the robot packets */
+    Watchdog* watchdog = Watchdog::getInstance();
+    watchdog->setThreshold (Settings::get ("Watchdog Threshold",
+                                           watchdog->threshold()).toInt());
+    QMetaObject::invokeMethod (watchdog, "init");
+}
+
+void MainWindow::startHostMetrics()
+{
+    /* Host computer status, sampled from a background thread */
+    HostMetrics* metrics = HostMetrics::getInstance();
+    metrics->setTimelineEnabled (Settings::get ("Network Timeline",
+                                                false).toBool());
+    updatePcStatusWidgets (metrics->snapshot());
+    connect (metrics, SIGNAL (snapshotChanged (HM_Snapshot)),
+             this,    SLOT   (updatePcStatusWidgets (HM_Snapshot)));
+    QMetaObject::invokeMethod (metrics, "init");
+}
+
+void MainWindow::showAdvancedSettings()
+{
+    createAdvancedSettings();
+    m_advancedSettings->show();
+}
+
+void MainWindow::onStartupFinished()
+{
+    Startup* startup = Startup::getInstance();
+
+    m_ds->consoleStore()->append (
+        tr ("INFO: Started in %1 ms (background tasks done after %2 ms)")
+        .arg (startup->timeToInteractive())
+        .arg (startup->elapsed()));
 }
 
 void MainWindow::setRobotEnabled (bool enabled)
@@ -373,28 +617,72 @@ void MainWindow::setRobotEnabled (bool enabled)
 void MainWindow::updateLabelText (QLabel* label, QString text)
 {
     if (m_network)
-        label->setText (text);
+        m_updater->setText (label, text);
 
     else
-        label->setText ("--.--");
+        m_updater->setText (label, "--.--");
+}
+
+void MainWindow::onStateChanged (DS_State state, int fields)
+{
+    /* The other labels depend on the network status, update it first */
+    if (fields & DS_NetworkField) {
+        onNetworkChanged (state.network);
+        fields |= DS_VoltageField | DS_LibVersionField | DS_RioVersionField;
+        fields |= DS_RamUsageField | DS_DiskUsageField;
+    }
+
+    if (fields & DS_CodeField)
+        onCodeChanged (state.code);
+
+    if (fields & DS_RadioField)
+        onRadioChanged (state.radio);
+
+    if (fields & DS_VoltageField)
+        onVoltageChanged (state.voltage);
+
+    if (fields & DS_LibVersionField)
+        onLibVersionChanged (state.libVersion);
+
+    if (fields & DS_RioVersionField)
+        onRioVersionChanged (state.rioVersion);
+
+    if (fields & DS_RamUsageField)
+        onRamUsageChanged (state.ramTotal, state.ramUsed);
+
+    if (fields & DS_DiskUsageField)
+        onDiskUsageChanged (state.diskTotal, state.diskUsed);
+
+    if (fields & (DS_StatusField | DS_ControlModeField | DS_CodeField))
+        onRobotStatusChanged (state.status);
+
+    /* Run the clock only while the robot is enabled */
+    if (fields & DS_ControlModeField) {
+        if (state.controlMode != DS_Disabled)
+            m_clockTimer->start();
+        else
+            m_clockTimer->stop();
+
+        updateElapsedTime();
+    }
 }
 
 void MainWindow::onCodeChanged (bool available)
 {
-    ui.RobotCode->setChecked (available);
+    m_updater->setChecked (ui.RobotCode, available);
 }
 
 void MainWindow::onNetworkChanged (bool available)
 {
     m_network = available;
 
-    ui.RobotCheck->setChecked (available);
-    ui.Communications->setChecked (available);
+    m_updater->setChecked (ui.RobotCheck, available);
+    m_updater->setChecked (ui.Communications, available);
 }
 
 void MainWindow::onRadioChanged (bool available)
 {
-    ui.DsRadioCheck->setChecked (available);
+    m_updater->setChecked (ui.DsRadioCheck, available);
 }
 
 void MainWindow::onVoltageChanged (float voltage)
@@ -413,6 +701,18 @@ void MainWindow::onRioVersionChanged (QString version)
 }
 
 void MainWindow::onRobotStatusChanged (QString status)
+{
+    m_status = status;
+    updateStatusLabel();
+}
+
+void MainWindow::updateElapsedTime()
+{
+    m_updater->setText (ui.ElapsedTime,
+                        DS_GetElapsedTimeString (m_ds->elapsedTime()));
+}
+
+void MainWindow::updateStatusLabel()
 {
     /* Do some wicked shit to get 'TeleOp Disabled' instead of 'Disabled' */
     if (m_ds->canBeEnabled() && m_ds->operationMode() != DS_EmergencyStop) {
@@ -431,27 +731,31 @@ void MainWindow::onRobotStatusChanged (QString status)
             else if (ui.Practice->isChecked())
                 mode = ui.Practice->text();
 
-            ui.StatusLabel->setText (QString ("%1 Disabled").arg (mode));
+            m_updater->setText (ui.StatusLabel,
+                                QString ("%1 Disabled").arg (mode));
         }
 
         /* Easy, just append 'Enabled' to the current operation mode */
         else
-            ui.StatusLabel->setText (tr ("%1 Enabled").arg (status));
+            m_updater->setText (ui.StatusLabel,
+                                tr ("%1 Enabled").arg (m_status));
     }
 
     /* Robot is in E-Stop or something is fucked up */
     else
-        ui.StatusLabel->setText (status);
+        m_updater->setText (ui.StatusLabel, m_status);
 }
 
 void MainWindow::onRamUsageChanged (int total, int used)
 {
-    updateLabelText (ui.RamUsage, tr ("%1 MB / %2 MB").arg (used, total));
+    updateLabelText (ui.RamUsage,
+                     tr ("%1 MB / %2 MB").arg (used).arg (total));
 }
 
 void MainWindow::onDiskUsageChanged (int total, int used)
 {
-    updateLabelText (ui.DiskUsage, tr ("%1 MB / %2 MB").arg (used, total));
+    updateLabelText (ui.DiskUsage,
+                     tr ("%1 MB / %2 MB").arg (used).arg (total));
 }
 
 //------------------------------------------------------------------------------
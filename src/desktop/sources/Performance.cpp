@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+#include <QShowEvent>
+#include <QHideEvent>
+#include <DriverStation.h>
+
+#include "Startup.h"
+#include "Dashboard.h"
+#include "HostMetrics.h"
+#include "Performance.h"
+
+/* Milliseconds between each refresh of the dialog */
+#define _REFRESH_INTERVAL 1000
+
+Performance::Performance()
+{
+    ui.setupUi (this);
+    ui.MetricsTree->setColumnWidth (0, 220);
+
+    m_timer = new QTimer (this);
+    m_timer->setInterval (_REFRESH_INTERVAL);
+
+    connect (m_timer, SIGNAL (timeout()), this, SLOT (refresh()));
+    connect (ui.ResetButton, SIGNAL (clicked()), this, SLOT (onResetClicked()));
+}
+
+void Performance::showEvent (QShowEvent* event)
+{
+    QDialog::showEvent (event);
+
+    refresh();
+    m_timer->start();
+}
+
+void Performance::hideEvent (QHideEvent* event)
+{
+    QDialog::hideEvent (event);
+    m_timer->stop();
+}
+
+void Performance::refresh()
+{
+    DS_Profiler* profiler = DS_Profiler::getInstance();
+    DS_ProcessStats process = profiler->processStats();
+    QList<DS_TimerStats> timers = profiler->timerStats();
+
+    ui.MetricsTree->clear();
+
+    QStringList cpu;
+    cpu.append (tr ("CPU usage"));
+    cpu.append (tr ("%1% (%2 s total)").arg (process.cpuUsage)
+                .arg (process.cpuTime / 1000.0, 0, 'f', 1));
+
+    QStringList memory;
+    memory.append (tr ("Resident memory"));
+    memory.append (process.residentMemory < 0 ? tr ("Unknown") :
+                   tr ("%1 MB").arg (process.residentMemory / 1024.0,
+                                     0, 'f', 1));
+
+    QStringList files;
+    files.append (tr ("Open files"));
+    files.append (process.openFiles < 0 ? tr ("Unknown") :
+                  QString::number (process.openFiles));
+
+    QStringList latency;
+    latency.append (tr ("Event loop latency"));
+    latency.append (tr ("%1 ms (worst %2 ms)").arg (process.loopLatency)
+                    .arg (process.maxLoopLatency));
+
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (cpu));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (memory));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (files));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (latency));
+
+    DS_LinkStats link = DriverStation::getInstance()->robotLink()->stats();
+
+    QStringList loss;
+    loss.append (tr ("Robot packets lost"));
+    loss.append (tr ("%1% (%2 of %3 total)").arg (link.lossRate)
+                 .arg (link.lost).arg (link.sent));
+
+    QStringList roundTrip;
+    roundTrip.append (tr ("Robot round trip time"));
+    roundTrip.append (link.latency < 0 ? tr ("Unknown") :
+                      tr ("%1 ms (worst %2 ms)").arg (link.latency)
+                      .arg (link.maxLatency));
+
+    DS_RateController* rate = DriverStation::getInstance()->rateController();
+
+    QStringList packetRate;
+    packetRate.append (tr ("Control packet rate"));
+    packetRate.append (tr ("Every %1 ms").arg (rate->interval()));
+
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (loss));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (roundTrip));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (packetRate));
+
+    /* Only show the interfaces that are being used */
+    HM_Snapshot snapshot = HostMetrics::getInstance()->snapshot();
+    foreach (HM_Interface entry, snapshot.interfaces) {
+        if (entry.name == "lo" || entry.rxRate + entry.txRate == 0)
+            continue;
+
+        QStringList item;
+        item.append (tr ("Interface %1").arg (entry.name));
+        item.append (tr ("%1 errors, %2 drops")
+                     .arg (entry.rxErrors + entry.txErrors)
+                     .arg (entry.rxDrops + entry.txDrops));
+
+        if (entry.retries >= 0)
+            item[1].append (tr (", %1 retries, quality %2")
+                            .arg (entry.retries).arg (entry.linkQuality));
+
+        ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (item));
+    }
+
+    foreach (DS_TimerStats timer, timers) {
+        QStringList item;
+        item.append (tr ("%1 (every %2 ms)").arg (timer.name)
+                     .arg (timer.interval));
+        item.append (tr ("%1 ms late (avg %2, worst %3)").arg (timer.last)
+                     .arg (timer.average).arg (timer.maximum));
+
+        ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (item));
+    }
+
+    /* Show if the dashboard is starving the DriverStation */
+    Dashboard* dashboard = Dashboard::getInstance();
+    if (dashboard->status() != Dashboard::Stopped) {
+        QStringList states;
+        states.append (tr ("Stopped"));
+        states.append (tr ("Waiting for robot"));
+        states.append (tr ("Starting"));
+        states.append (tr ("Ready after %1 ms").arg (dashboard->readyTime()));
+        states.append (tr ("Crashed"));
+        states.append (tr ("Not probed, assumed ready"));
+
+        QStringList item;
+        item.append (tr ("Dashboard"));
+        item.append (states.at (dashboard->status()));
+
+        if (dashboard->cpuUsage() >= 0)
+            item[1].append (tr (", CPU %1%").arg (dashboard->cpuUsage()));
+
+        if (dashboard->residentMemory() >= 0)
+            item[1].append (tr (", %1 MB").arg (dashboard->residentMemory()
+                                                / 1024.0, 0, 'f', 1));
+
+        ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (item));
+    }
+
+    /* Show how long it took to start the application */
+    Startup* startup = Startup::getInstance();
+
+    QStringList interactive;
+    interactive.append (tr ("Time to interactive"));
+    interactive.append (tr ("%1 ms").arg (startup->timeToInteractive()));
+
+    QStringList firstPacket;
+    firstPacket.append (tr ("Time to first control packet"));
+    if (startup->timeToFirstPacket() >= 0)
+        firstPacket.append (tr ("%1 ms").arg (startup->timeToFirstPacket()));
+    else
+        firstPacket.append (tr ("No packet sent yet"));
+
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (interactive));
+    ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (firstPacket));
+
+    foreach (SU_Phase phase, startup->phases()) {
+        QStringList item;
+        item.append (phase.deferred ? tr ("Startup: %1 (deferred)")
+                     .arg (phase.name) : tr ("Startup: %1").arg (phase.name));
+        if (phase.background)
+            item.append (tr ("In background (started at %1 ms)")
+                         .arg (phase.start));
+        else
+            item.append (tr ("%1 ms (at %2 ms)").arg (phase.duration)
+                         .arg (phase.start));
+
+        ui.MetricsTree->addTopLevelItem (new QTreeWidgetItem (item));
+    }
+}
+
+void Performance::onResetClicked()
+{
+    DS_Profiler::getInstance()->resetStats();
+    refresh();
+}
@@ -23,22 +23,161 @@
 #include "Settings.h"
 #include "AssemblyInfo.h"
 
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
+#include <QThread>
 #include <QSettings>
+#include <QDateTime>
+#include <QStringList>
+#include <QMutexLocker>
+#include <QCoreApplication>
 
-static QSettings* settings =
-    new QSettings (AssemblyInfo::organization(), AssemblyInfo::name());
+/* Milliseconds after the last change before the settings are written */
+#define _WRITE_DELAY 3000
+
+/* Pending changes are written at least this often, even if they continue */
+#define _MAX_WRITE_DELAY 15000
+
+/* Values of all the settings, loaded from disk once */
+static QHash<QString, QVariant> values;
+
+/* Changes that have not been written to disk yet */
+static QHash<QString, QVariant> pending;
+static bool clearPending = false;
+
+static bool loaded = false;
+static QMutex mutex;
+static SettingsWriter* writer = nullptr;
+
+/*
+ * Reads every setting into memory and starts the writer thread
+ */
+static void load()
+{
+    if (loaded)
+        return;
+
+    loaded = true;
+
+    QSettings settings (AssemblyInfo::organization(), AssemblyInfo::name());
+    foreach (QString key, settings.allKeys())
+        values.insert (key, settings.value (key));
+
+    QThread* thread = new QThread();
+    writer = new SettingsWriter();
+    writer->moveToThread (thread);
+
+    /* Write the pending changes before the writer thread stops */
+    QCoreApplication* app = QCoreApplication::instance();
+    QObject::connect (app,    SIGNAL (aboutToQuit()),
+                      writer, SLOT   (flush()),
+                      Qt::BlockingQueuedConnection);
+    QObject::connect (app,    SIGNAL (aboutToQuit()),
+                      thread, SLOT   (quit()));
+
+    thread->start (QThread::LowPriority);
+}
+
+/*
+ * Asks the writer thread to write the changes once they settle down
+ */
+static void scheduleWrite()
+{
+    QMetaObject::invokeMethod (writer, "schedule", Qt::QueuedConnection);
+}
+
+//------------------------------------------------------------------------------
+// Settings
+//------------------------------------------------------------------------------
 
 void Settings::clear()
 {
-    settings->clear();
+    QMutexLocker locker (&mutex);
+    load();
+
+    values.clear();
+    pending.clear();
+    clearPending = true;
+
+    scheduleWrite();
 }
 
 void Settings::set (QString key, QVariant value)
 {
-    settings->setValue (key, value);
+    QMutexLocker locker (&mutex);
+    load();
+
+    /* Nothing to write if the value did not change */
+    if (values.contains (key) && values.value (key) == value)
+        return;
+
+    values.insert (key, value);
+    pending.insert (key, value);
+
+    scheduleWrite();
 }
 
 QVariant Settings::get (QString key, QVariant defaultValue)
 {
-    return settings->value (key, defaultValue);
+    QMutexLocker locker (&mutex);
+    load();
+
+    return values.value (key, defaultValue);
+}
+
+//------------------------------------------------------------------------------
+// SettingsWriter
+//------------------------------------------------------------------------------
+
+SettingsWriter::SettingsWriter()
+{
+    m_firstChange = -1;
+
+    m_timer = new QTimer (this);
+    m_timer->setSingleShot (true);
+    m_timer->setInterval (_WRITE_DELAY);
+
+    connect (m_timer, SIGNAL (timeout()), this, SLOT (flush()));
+}
+
+void SettingsWriter::schedule()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    if (m_firstChange < 0)
+        m_firstChange = now;
+
+    if (now - m_firstChange >= _MAX_WRITE_DELAY)
+        flush();
+    else
+        m_timer->start();
+}
+
+void SettingsWriter::flush()
+{
+    m_timer->stop();
+    m_firstChange = -1;
+
+    /* Take the pending changes, so that the GUI thread never waits on disk */
+    mutex.lock();
+    bool clear = clearPending;
+    QHash<QString, QVariant> changes = pending;
+    pending.clear();
+    clearPending = false;
+    mutex.unlock();
+
+    if (!clear && changes.isEmpty())
+        return;
+
+    QSettings settings (AssemblyInfo::organization(), AssemblyInfo::name());
+
+    if (clear)
+        settings.clear();
+
+    QHash<QString, QVariant>::const_iterator i;
+    for (i = changes.constBegin(); i != changes.constEnd(); ++i)
+        settings.setValue (i.key(), i.value());
+
+    settings.sync();
 }
@@ -28,8 +28,6 @@
 #include "Settings.h"
 #include "SmartWindow.h"
 
-#define _UPDATE_INTERVAL 100
-
 //------------------------------------------------------------------------------
 // Class initialization functions
 //------------------------------------------------------------------------------
@@ -39,9 +37,18 @@ SmartWindow::SmartWindow()
     m_closingDown = false;
     m_useFixedSize = true;
     m_promptOnQuit = true;
+    m_resizePending = false;
     m_windowMode = Invalid;
 
-    resizeToFit();
+    /* Keep the docked window attached to the bottom of the screen */
+    QDesktopWidget* desktop = QApplication::desktop();
+    connect (desktop, SIGNAL (resized (int)),
+             this,    SLOT   (scheduleResize()));
+    connect (desktop, SIGNAL (workAreaResized (int)),
+             this,    SLOT   (scheduleResize()));
+    connect (desktop, SIGNAL (screenCountChanged (int)),
+             this,    SLOT   (scheduleResize()));
+
     setWindowMode (Settings::get ("Docked", false).toBool() ? Docked : Normal);
 }
 
@@ -101,6 +108,14 @@ void SmartWindow::closeEvent (QCloseEvent* e)
     e->accept();
 }
 
+bool SmartWindow::event (QEvent* e)
+{
+    if (e->type() == QEvent::LayoutRequest)
+        scheduleResize();
+
+    return QMainWindow::event (e);
+}
+
 //------------------------------------------------------------------------------
 // Functions that change the appearance and behaviour of the window
 //------------------------------------------------------------------------------
@@ -108,6 +123,7 @@ void SmartWindow::closeEvent (QCloseEvent* e)
 void SmartWindow::setUseFixedSize (bool fixed)
 {
     m_useFixedSize = fixed;
+    scheduleResize();
 }
 
 void SmartWindow::setPromptOnQuit (bool prompt)
@@ -144,28 +160,43 @@ void SmartWindow::setWindowMode (WindowMode mode)
         setWindowFlags (Qt::FramelessWindowHint);
 
     showNormal();
+    scheduleResize();
 }
 
 //------------------------------------------------------------------------------
-// Functions that are called constantly with a timer
+// Functions that resize the window when its layout or the screen changes
 //------------------------------------------------------------------------------
 
+void SmartWindow::scheduleResize()
+{
+    if (!m_resizePending) {
+        m_resizePending = true;
+        QTimer::singleShot (0, this, SLOT (resizeToFit()));
+    }
+}
+
 void SmartWindow::resizeToFit()
 {
+    m_resizePending = false;
+
+    /* Only touch the geometry when it changes, to avoid useless layouts */
     if (!isDocked() && m_useFixedSize) {
-        resize (0, 0);
-        setMinimumSize (size());
-        setMaximumSize (size());
+        QSize target = minimumSizeHint();
+
+        if (minimumSize() != target || maximumSize() != target)
+            setFixedSize (target);
     }
 
     else if (isDocked()) {
-        QDesktopWidget w;
-        setMinimumWidth (w.width());
-        setMaximumWidth (w.width());
-        setMinimumHeight (size().height());
-        setMaximumHeight (size().height());
-        move (0, w.availableGeometry().height() - height());
-    }
+        QDesktopWidget* desktop = QApplication::desktop();
+        QSize target (desktop->width(), minimumSizeHint().height());
+        QPoint position (0, desktop->availableGeometry().height()
+                         - target.height());
 
-    QTimer::singleShot (_UPDATE_INTERVAL, this, SLOT (resizeToFit()));
+        if (minimumSize() != target || maximumSize() != target)
+            setFixedSize (target);
+
+        if (pos() != position)
+            move (position);
+    }
 }
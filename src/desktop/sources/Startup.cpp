@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QTimer>
+
+#include "Startup.h"
+
+Startup* Startup::m_instance = nullptr;
+
+Startup::Startup()
+{
+    m_clock.start();
+
+    m_phaseStart = 0;
+    m_phaseBackground = false;
+    m_interactive = -1;
+    m_firstPacket = -1;
+}
+
+Startup* Startup::getInstance()
+{
+    if (m_instance == nullptr)
+        m_instance = new Startup();
+
+    return m_instance;
+}
+
+qint64 Startup::elapsed() const
+{
+    return m_clock.elapsed();
+}
+
+QList<SU_Phase> Startup::phases() const
+{
+    return m_phases;
+}
+
+qint64 Startup::timeToFirstPacket() const
+{
+    return m_firstPacket;
+}
+
+qint64 Startup::timeToInteractive() const
+{
+    return m_interactive;
+}
+
+void Startup::beginPhase (const QString& name)
+{
+    endPhase();
+
+    m_phase = name;
+    m_phaseStart = elapsed();
+    m_phaseBackground = false;
+}
+
+void Startup::endPhase()
+{
+    if (m_phase.isEmpty())
+        return;
+
+    SU_Phase phase;
+    phase.name = m_phase;
+    phase.start = m_phaseStart;
+    phase.duration = m_phaseBackground ? -1 : elapsed() - m_phaseStart;
+    phase.deferred = m_interactive >= 0;
+    phase.background = m_phaseBackground;
+
+    m_phases.append (phase);
+    m_phase.clear();
+}
+
+void Startup::markFirstPacket()
+{
+    if (m_firstPacket < 0)
+        m_firstPacket = elapsed();
+}
+
+void Startup::defer (const QString& name,
+                     QObject* receiver,
+                     const char* method,
+                     Priority priority)
+{
+    Task task;
+    task.name = name;
+    task.method = method;
+    task.receiver = receiver;
+    task.priority = priority;
+
+    /* Keep the queue sorted by priority */
+    int index = 0;
+    while (index < m_tasks.count() && m_tasks.at (index).priority <= priority)
+        ++index;
+
+    m_tasks.insert (index, task);
+}
+
+void Startup::finish()
+{
+    endPhase();
+    QTimer::singleShot (0, this, SLOT (markInteractive()));
+}
+
+void Startup::markInteractive()
+{
+    m_interactive = elapsed();
+    runNextTask();
+}
+
+void Startup::runNextTask()
+{
+    if (m_tasks.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    Task task = m_tasks.takeFirst();
+
+    /* Objects in other threads will run the task in their own thread, we
+     * do not know how long it takes, so the phase has no duration */
+    beginPhase (task.name);
+    if (!task.receiver.isNull()) {
+        m_phaseBackground = task.receiver->thread() != thread();
+        QMetaObject::invokeMethod (task.receiver, task.method.constData(),
+                                   Qt::AutoConnection);
+    }
+    endPhase();
+
+    QTimer::singleShot (0, this, SLOT (runNextTask()));
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QFile>
+#include <QDateTime>
+#include <QTextStream>
+
+#include "TelemetryExporter.h"
+
+TelemetryExporter::TelemetryExporter (const QVector<TelemetryStore::Blocks>&
+                                      blocks,
+                                      qint64 startTime,
+                                      const QString& path,
+                                      QObject* parent) : QThread (parent)
+{
+    m_path = path;
+    m_blocks = blocks;
+    m_startTime = startTime;
+}
+
+void TelemetryExporter::run()
+{
+    QFile file (m_path);
+    if (!file.open (QFile::WriteOnly | QFile::Truncate | QFile::Text)) {
+        emit exportFinished (false, m_path);
+        return;
+    }
+
+    const char* names[TS_ChannelCount] = {
+        "Voltage (V)",
+        "Packet loss (%)",
+        "Round trip time (ms)",
+        "CPU usage (%)"
+    };
+
+    QTextStream stream (&file);
+    stream << "Time,Channel,Value\n";
+
+    QVector<TS_Sample> samples;
+    for (int i = 0; i < m_blocks.count() && i < TS_ChannelCount; ++i) {
+        foreach (const TelemetryStore::Block& block, m_blocks.at (i)) {
+            TelemetryStore::decode (block, samples);
+            foreach (const TS_Sample& sample, samples) {
+                QDateTime date = QDateTime::fromMSecsSinceEpoch (m_startTime
+                                                                 + sample.time);
+
+                stream << date.toString ("yyyy-MM-ddTHH:mm:ss.zzz") << ","
+                       << names[i] << ","
+                       << sample.value << "\n";
+            }
+        }
+    }
+
+    stream.flush();
+    file.close();
+
+    emit exportFinished (file.error() == QFile::NoError, m_path);
+}
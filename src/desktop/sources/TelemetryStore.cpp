@@ -0,0 +1,476 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtEndian>
+#include <QDateTime>
+
+#include <string.h>
+
+#include "TelemetryStore.h"
+#include "TelemetryExporter.h"
+
+/* Number of values in each compressed block */
+#define _BLOCK_SIZE 256
+
+TelemetryStore* TelemetryStore::m_instance = nullptr;
+
+//------------------------------------------------------------------------------
+// Bit stream helpers
+//------------------------------------------------------------------------------
+
+/* Fields are never wider than 32 bits, so with the bit offset inside the
+ * first byte they always fit in a single 64-bit word */
+static void writeBits (QByteArray& data, int& bitCount,
+                       quint64 value, int count)
+{
+    if (count <= 0)
+        return;
+
+    int first = bitCount / 8;
+    int offset = bitCount % 8;
+    int bytes = (offset + count + 7) / 8;
+
+    /* Grow the stream with zeroed bytes */
+    int size = data.size();
+    if (size < first + bytes) {
+        data.resize (first + bytes);
+        memset (data.data() + size, 0, first + bytes - size);
+    }
+
+    /* Place the field in a big-endian word that begins in the first byte */
+    value &= (Q_UINT64_C (1) << count) - 1;
+    quint64 word = value << (64 - offset - count);
+
+    uchar* output = reinterpret_cast<uchar*> (data.data()) + first;
+    for (int i = 0; i < bytes; ++i)
+        output[i] |= (uchar) (word >> (56 - 8 * i));
+
+    bitCount += count;
+}
+
+static quint64 readBits (const QByteArray& data, int& position, int count)
+{
+    if (count <= 0)
+        return 0;
+
+    int first = position / 8;
+    int available = data.size() - first;
+    const uchar* input = reinterpret_cast<const uchar*> (data.constData())
+                         + first;
+
+    /* Load the 64 bits that begin in the first byte of the field */
+    quint64 word = 0;
+    if (available >= 8)
+        word = qFromBigEndian<quint64> (input);
+
+    else {
+        for (int i = 0; i < 8; ++i)
+            word = (word << 8) | (i < available ? input[i] : 0);
+    }
+
+    word <<= position % 8;
+    position += count;
+
+    return word >> (64 - count);
+}
+
+static int leadingZeros (quint32 value)
+{
+    int count = 0;
+    while (count < 32 && !(value & (0x80000000u >> count)))
+        ++count;
+
+    return count;
+}
+
+static int trailingZeros (quint32 value)
+{
+    int count = 0;
+    while (count < 32 && !(value & (1u << count)))
+        ++count;
+
+    return count;
+}
+
+static void mergePoint (QVector<CS_Point>& bins,
+                        QVector<bool>& used,
+                        int column,
+                        const CS_Point& point)
+{
+    if (!used.at (column)) {
+        used[column] = true;
+        bins[column] = point;
+    }
+
+    else {
+        bins[column].min = qMin (bins.at (column).min, point.min);
+        bins[column].max = qMax (bins.at (column).max, point.max);
+    }
+}
+
+//------------------------------------------------------------------------------
+// Class initialization functions
+//------------------------------------------------------------------------------
+
+TelemetryStore::TelemetryStore()
+{
+    m_startTime = QDateTime::currentMSecsSinceEpoch();
+    m_clock.start();
+    m_channels.resize (TS_ChannelCount);
+}
+
+TelemetryStore* TelemetryStore::getInstance()
+{
+    if (m_instance == nullptr)
+        m_instance = new TelemetryStore();
+
+    return m_instance;
+}
+
+void TelemetryStore::init()
+{
+    connect (DriverStation::getInstance(),
+             SIGNAL (stateChanged   (DS_State, int)),
+             this,
+             SLOT   (onStateChanged (DS_State, int)));
+    connect (HostMetrics::getInstance(),
+             SIGNAL (snapshotChanged   (HM_Snapshot)),
+             this,
+             SLOT   (onSnapshotChanged (HM_Snapshot)));
+}
+
+//------------------------------------------------------------------------------
+// Functions that read the store
+//------------------------------------------------------------------------------
+
+qint64 TelemetryStore::time() const
+{
+    return m_clock.elapsed();
+}
+
+int TelemetryStore::count (TS_Channel channel) const
+{
+    int count = 0;
+    foreach (const Block& block, m_channels.at (channel).blocks)
+        count += block.count;
+
+    return count;
+}
+
+qint64 TelemetryStore::memoryUsage() const
+{
+    qint64 bytes = 0;
+
+    foreach (const Channel& channel, m_channels) {
+        foreach (const Block& block, channel.blocks)
+            bytes += sizeof (Block) + block.data.capacity();
+    }
+
+    return bytes;
+}
+
+QVector<CS_Point> TelemetryStore::points (TS_Channel channel,
+                                          qint64 from, qint64 to,
+                                          int columns) const
+{
+    QVector<CS_Point> result;
+
+    if (columns <= 0 || to <= from)
+        return result;
+
+    QVector<CS_Point> bins (columns);
+    QVector<bool> used (columns, false);
+    QVector<TS_Sample> decoded;
+
+    foreach (const Block& block, m_channels.at (channel).blocks) {
+        if (block.lastTime < from || block.firstTime > to)
+            continue;
+
+        int first = (block.firstTime - from) * (columns - 1) / (to - from);
+        int last = (block.lastTime - from) * (columns - 1) / (to - from);
+
+        /* The block covers one column or crosses into the next one, fold
+         * its summary into the column of its middle */
+        if (block.firstTime >= from && block.lastTime <= to
+                && last - first <= 1) {
+            CS_Point point;
+            point.time = block.firstTime;
+            point.min = block.min;
+            point.max = block.max;
+
+            qint64 middle = (block.firstTime + block.lastTime) / 2;
+            mergePoint (bins, used,
+                        (middle - from) * (columns - 1) / (to - from),
+                        point);
+            continue;
+        }
+
+        /* The block spans several columns (or the edge of the period) */
+        decode (block, decoded);
+        foreach (const TS_Sample& sample, decoded) {
+            if (sample.time < from || sample.time > to)
+                continue;
+
+            CS_Point point;
+            point.time = sample.time;
+            point.min = sample.value;
+            point.max = sample.value;
+
+            mergePoint (bins, used,
+                        (sample.time - from) * (columns - 1) / (to - from),
+                        point);
+        }
+    }
+
+    for (int i = 0; i < columns; ++i) {
+        if (used.at (i))
+            result.append (bins.at (i));
+    }
+
+    return result;
+}
+
+QVector<TS_Sample> TelemetryStore::samples (TS_Channel channel,
+                                            qint64 from, qint64 to) const
+{
+    QVector<TS_Sample> result;
+    QVector<TS_Sample> decoded;
+
+    foreach (const Block& block, m_channels.at (channel).blocks) {
+        if (block.lastTime < from || block.firstTime > to)
+            continue;
+
+        decode (block, decoded);
+        foreach (const TS_Sample& sample, decoded) {
+            if (sample.time >= from && sample.time <= to)
+                result.append (sample);
+        }
+    }
+
+    return result;
+}
+
+void TelemetryStore::exportToFile (const QString& path)
+{
+    /* Only the last block of each channel is copied by the next append() */
+    QVector<Blocks> blocks;
+    foreach (const Channel& channel, m_channels)
+        blocks.append (channel.blocks);
+
+    TelemetryExporter* exporter = new TelemetryExporter (blocks, m_startTime,
+                                                         path, this);
+
+    connect (exporter, SIGNAL (exportFinished (bool, QString)),
+             this,     SIGNAL (exportFinished (bool, QString)));
+    connect (exporter, SIGNAL (finished()),
+             exporter, SLOT   (deleteLater()));
+
+    exporter->start (QThread::LowPriority);
+}
+
+//------------------------------------------------------------------------------
+// Functions that write to the store
+//------------------------------------------------------------------------------
+
+void TelemetryStore::append (TS_Channel channel, float value)
+{
+    qint64 now = time();
+
+    encode (m_channels[channel], now, value);
+    emit sampleAdded (channel, now, value);
+}
+
+void TelemetryStore::onStateChanged (DS_State state, int fields)
+{
+    if (fields & DS_VoltageField)
+        append (TS_Voltage, state.voltage);
+}
+
+void TelemetryStore::onSnapshotChanged (HM_Snapshot snapshot)
+{
+    append (TS_CpuUsage, snapshot.cpuUsage);
+    append (TS_PacketLoss, snapshot.link.lossRate);
+
+    /* The latency is unknown while the robot does not reply */
+    if (snapshot.link.latency >= 0)
+        append (TS_Latency, snapshot.link.latency);
+}
+
+//------------------------------------------------------------------------------
+// Compression functions
+//------------------------------------------------------------------------------
+
+void TelemetryStore::encode (Channel& channel, qint64 time, float value)
+{
+    quint32 bits;
+    memcpy (&bits, &value, sizeof (bits));
+
+    /* Begin a new block with the uncompressed value */
+    if (channel.blocks.isEmpty()
+            || channel.blocks.last().count >= _BLOCK_SIZE) {
+        if (!channel.blocks.isEmpty())
+            channel.blocks.last().data.squeeze();
+
+        Block block;
+        block.firstTime = time;
+        block.lastTime = time;
+        block.min = value;
+        block.max = value;
+        block.count = 1;
+        block.bitCount = 0;
+        writeBits (block.data, block.bitCount, bits, 32);
+
+        channel.blocks.append (block);
+        channel.lastDelta = 0;
+        channel.lastValue = bits;
+        channel.lastLeading = -1;
+        channel.lastTrailing = 0;
+        return;
+    }
+
+    Block& block = channel.blocks.last();
+
+    /* Write the delta of the time delta */
+    qint64 delta = time - block.lastTime;
+    qint64 dod = delta - channel.lastDelta;
+
+    if (dod == 0)
+        writeBits (block.data, block.bitCount, 0x0, 1);
+
+    else if (dod >= -63 && dod <= 64) {
+        writeBits (block.data, block.bitCount, 0x2, 2);
+        writeBits (block.data, block.bitCount, dod + 63, 7);
+    }
+
+    else if (dod >= -255 && dod <= 256) {
+        writeBits (block.data, block.bitCount, 0x6, 3);
+        writeBits (block.data, block.bitCount, dod + 255, 9);
+    }
+
+    else if (dod >= -2047 && dod <= 2048) {
+        writeBits (block.data, block.bitCount, 0xe, 4);
+        writeBits (block.data, block.bitCount, dod + 2047, 12);
+    }
+
+    else {
+        writeBits (block.data, block.bitCount, 0xf, 4);
+        writeBits (block.data, block.bitCount, (quint32) dod, 32);
+    }
+
+    /* Write the XOR with the previous value */
+    quint32 xored = bits ^ channel.lastValue;
+
+    if (xored == 0)
+        writeBits (block.data, block.bitCount, 0x0, 1);
+
+    else {
+        int leading = leadingZeros (xored);
+        int trailing = trailingZeros (xored);
+
+        /* The meaningful bits fit in the previous window */
+        if (channel.lastLeading >= 0
+                && leading >= channel.lastLeading
+                && trailing >= channel.lastTrailing) {
+            writeBits (block.data, block.bitCount, 0x2, 2);
+            writeBits (block.data, block.bitCount,
+                       xored >> channel.lastTrailing,
+                       32 - channel.lastLeading - channel.lastTrailing);
+        }
+
+        /* Write a new window */
+        else {
+            int length = 32 - leading - trailing;
+
+            writeBits (block.data, block.bitCount, 0x3, 2);
+            writeBits (block.data, block.bitCount, leading, 5);
+            writeBits (block.data, block.bitCount, length - 1, 5);
+            writeBits (block.data, block.bitCount, xored >> trailing, length);
+
+            channel.lastLeading = leading;
+            channel.lastTrailing = trailing;
+        }
+    }
+
+    channel.lastDelta = delta;
+    channel.lastValue = bits;
+
+    block.count += 1;
+    block.lastTime = time;
+    block.min = qMin (block.min, value);
+    block.max = qMax (block.max, value);
+}
+
+void TelemetryStore::decode (const Block& block, QVector<TS_Sample>& samples)
+{
+    /* Keep the memory of the vector, it is reused for every block */
+    samples.resize (0);
+    samples.reserve (block.count);
+
+    int position = 0;
+    int leading = 0;
+    int trailing = 0;
+    qint64 delta = 0;
+
+    TS_Sample sample;
+    sample.time = block.firstTime;
+    quint32 bits = readBits (block.data, position, 32);
+    memcpy (&sample.value, &bits, sizeof (bits));
+    samples.append (sample);
+
+    for (int i = 1; i < block.count; ++i) {
+        /* Read the delta of the time delta */
+        qint64 dod = 0;
+
+        if (readBits (block.data, position, 1) == 0)
+            dod = 0;
+
+        else if (readBits (block.data, position, 1) == 0)
+            dod = (qint64) readBits (block.data, position, 7) - 63;
+
+        else if (readBits (block.data, position, 1) == 0)
+            dod = (qint64) readBits (block.data, position, 9) - 255;
+
+        else if (readBits (block.data, position, 1) == 0)
+            dod = (qint64) readBits (block.data, position, 12) - 2047;
+
+        else
+            dod = (qint32) readBits (block.data, position, 32);
+
+        delta += dod;
+        sample.time += delta;
+
+        /* Read the XOR with the previous value */
+        if (readBits (block.data, position, 1) == 1) {
+            if (readBits (block.data, position, 1) == 1) {
+                leading = readBits (block.data, position, 5);
+                int length = readBits (block.data, position, 5) + 1;
+                trailing = 32 - leading - length;
+            }
+
+            int length = 32 - leading - trailing;
+            bits ^= readBits (block.data, position, length) << trailing;
+        }
+
+        memcpy (&sample.value, &bits, sizeof (bits));
+        samples.append (sample);
+    }
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QEvent>
+#include <QThread>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include <DriverStation.h>
+
+#include "Watchdog.h"
+
+#if defined __gnu_linux__
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <execinfo.h>
+#endif
+
+/* Milliseconds between each check of the watchdog */
+#define _CHECK_INTERVAL 50
+
+/* A heartbeat is posted to the GUI thread every N checks */
+#define _HEARTBEAT_RATE 2
+
+/* Default number of milliseconds that a heartbeat can wait */
+#define _DEFAULT_THRESHOLD 250
+
+/* The diagnostics file is rotated when it grows beyond this size */
+#define _MAX_LOG_SIZE (512 * 1024)
+
+/* Type of the heartbeat events posted to the GUI thread */
+#define _HEARTBEAT_EVENT static_cast<QEvent::Type> (QEvent::User + 3795)
+
+/* Time source shared by the watchdog and GUI threads */
+static QElapsedTimer watchdogClock;
+
+/* Number of heartbeats delivered by the GUI thread */
+static QAtomicInt delivered;
+
+#if defined __gnu_linux__
+#define _MAX_FRAMES 64
+#define _SAMPLE_SIGNAL SIGUSR2
+
+/* Filled by the signal handler, which runs in the GUI thread */
+static pthread_t guiThread;
+static int frameCount = 0;
+static void* frames[_MAX_FRAMES];
+
+/*
+ * Each sample has its own sequence number, the handler only writes the
+ * frames while a sample is requested and it bumps the write counter before
+ * and after doing so, which lets the watchdog detect a handler that runs
+ * late (after the timeout) and overwrites the frames while they are read
+ */
+static int lastSequence = 0;
+static QAtomicInt sampleDone;
+static QAtomicInt sampleWrites;
+static QAtomicInt sampleRequest;
+
+static void onSampleSignal (int signal)
+{
+    Q_UNUSED (signal);
+
+    int sequence = sampleRequest.loadAcquire();
+    if (sequence == 0)
+        return;
+
+    sampleWrites.fetchAndAddOrdered (1);
+    frameCount = backtrace (frames, _MAX_FRAMES);
+    sampleWrites.fetchAndAddOrdered (1);
+
+    sampleDone.storeRelease (sequence);
+}
+#endif
+
+/*
+ * Lives in the GUI thread and counts the heartbeats that it receives
+ */
+class WatchdogBeacon : public QObject
+{
+protected:
+    void customEvent (QEvent* event)
+    {
+        if (event->type() == _HEARTBEAT_EVENT)
+            delivered.ref();
+    }
+};
+
+static WatchdogBeacon* beacon = nullptr;
+
+Watchdog* Watchdog::m_instance = nullptr;
+
+Watchdog::Watchdog()
+{
+    m_ticks = 0;
+    m_stalled = false;
+    m_backlog = 0;
+    m_received = 0;
+    m_stallStart = 0;
+    m_threshold.store (_DEFAULT_THRESHOLD);
+
+    /* The instance is created from the GUI thread */
+    watchdogClock.start();
+    beacon = new WatchdogBeacon();
+
+#if defined __gnu_linux__
+    guiThread = pthread_self();
+
+    /* Load the unwinder now, it may allocate memory the first time */
+    backtrace (frames, 1);
+
+    struct sigaction action;
+    memset (&action, 0, sizeof (action));
+    action.sa_handler = onSampleSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset (&action.sa_mask);
+    sigaction (_SAMPLE_SIGNAL, &action, nullptr);
+#endif
+
+    m_thread = new QThread();
+    moveToThread (m_thread);
+    connect (QCoreApplication::instance(), SIGNAL (aboutToQuit()),
+             m_thread,                     SLOT   (quit()));
+
+    m_thread->start (QThread::HighPriority);
+}
+
+Watchdog* Watchdog::getInstance()
+{
+    if (m_instance == nullptr)
+        m_instance = new Watchdog();
+
+    return m_instance;
+}
+
+QString Watchdog::logFile()
+{
+    return QString ("%1/.qdriverstation/watchdog.log").arg (QDir::homePath());
+}
+
+int Watchdog::threshold()
+{
+    return m_threshold.load();
+}
+
+void Watchdog::init()
+{
+    check();
+}
+
+void Watchdog::setThreshold (int threshold)
+{
+    if (threshold > 0)
+        m_threshold.store (threshold);
+}
+
+void Watchdog::check()
+{
+    qint64 now = watchdogClock.elapsed();
+
+    /* Forget the heartbeats that the GUI thread has already received */
+    int count = delivered.load();
+    while (m_received < count && !m_heartbeats.isEmpty()) {
+        m_heartbeats.dequeue();
+        ++m_received;
+    }
+
+    qint64 age = m_heartbeats.isEmpty() ? 0 : now - m_heartbeats.head();
+
+    /* The oldest heartbeat is too old, sample the GUI thread right away */
+    if (!m_stalled && age > m_threshold.load()) {
+        m_stalled = true;
+        m_stallStart = m_heartbeats.head();
+        m_stack = sampleStack();
+    }
+
+    if (m_stalled) {
+        m_backlog = qMax (m_backlog, m_heartbeats.count());
+
+        /* The GUI thread is responsive again */
+        if (age <= m_threshold.load()) {
+            int duration = static_cast<int> (now - m_stallStart);
+            writeRecord (duration);
+            emit stallDetected (duration);
+
+            m_stalled = false;
+            m_backlog = 0;
+            m_stack.clear();
+        }
+    }
+
+    /* Post a new heartbeat to the GUI thread */
+    if (++m_ticks >= _HEARTBEAT_RATE) {
+        m_ticks = 0;
+        m_heartbeats.enqueue (now);
+        QCoreApplication::postEvent (beacon, new QEvent (_HEARTBEAT_EVENT));
+    }
+
+    QTimer::singleShot (_CHECK_INTERVAL, this, SLOT (check()));
+}
+
+QStringList Watchdog::sampleStack()
+{
+    QStringList stack;
+
+#if defined __gnu_linux__
+    int sequence = ++lastSequence;
+    sampleRequest.storeRelease (sequence);
+
+    if (pthread_kill (guiThread, _SAMPLE_SIGNAL) != 0) {
+        sampleRequest.storeRelease (0);
+        return stack;
+    }
+
+    /* Wait (at most 100 ms) for the GUI thread to run the handler */
+    for (int i = 0; i < 100 && sampleDone.loadAcquire() != sequence; ++i)
+        usleep (1000);
+
+    /* Handlers that run from now on will not touch the frames */
+    sampleRequest.storeRelease (0);
+    if (sampleDone.loadAcquire() != sequence)
+        return stack;
+
+    /* Copy the frames, unless a late handler is writing them */
+    int writes = sampleWrites.loadAcquire();
+    if (writes % 2 != 0)
+        return stack;
+
+    void* copy[_MAX_FRAMES];
+    int count = qBound (0, frameCount, _MAX_FRAMES);
+    memcpy (copy, frames, count * sizeof (void*));
+
+    /* The frames changed while they were copied, discard them */
+    if (sampleWrites.fetchAndAddOrdered (0) != writes)
+        return stack;
+
+    /* Skip the frames of the signal handler */
+    char** symbols = backtrace_symbols (copy, count);
+    if (symbols != nullptr) {
+        for (int i = 2; i < count; ++i)
+            stack.append (QString::fromLocal8Bit (symbols[i]));
+
+        free (symbols);
+    }
+#endif
+
+    return stack;
+}
+
+void Watchdog::writeRecord (int duration)
+{
+    QFile file (logFile());
+    QDir().mkpath (QFileInfo (file).absolutePath());
+
+    /* Keep the previous file when rotating, so we never lose a whole log */
+    if (file.size() > _MAX_LOG_SIZE) {
+        QFile::remove (logFile() + ".1");
+        QFile::rename (logFile(), logFile() + ".1");
+    }
+
+    if (!file.open (QFile::Append | QFile::Text))
+        return;
+
+    DS_ProcessStats process = DS_Profiler::getInstance()->processStats();
+
+    QTextStream stream (&file);
+    stream << QDateTime::currentDateTime().toString ("yyyy-MM-dd hh:mm:ss.zzz")
+           << " GUI thread stalled for " << duration << " ms, "
+           << m_backlog << " heartbeats pending, "
+           << "event loop latency " << process.loopLatency << " ms\n";
+
+    if (m_stack.isEmpty())
+        stream << "    (no stack sample available)\n";
+
+    foreach (QString frame, m_stack)
+        stream << "    " << frame << "\n";
+
+    stream << "\n";
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QLabel>
+#include <QTimer>
+#include <QAbstractButton>
+
+#include "WidgetUpdater.h"
+
+/* Milliseconds between each frame (about 60 frames per second) */
+#define _FRAME_INTERVAL 16
+
+WidgetUpdater::WidgetUpdater (QObject* parent) : QObject (parent)
+{
+    m_scheduled = false;
+}
+
+void WidgetUpdater::setText (QLabel* label, const QString& text)
+{
+    m_texts.insert (label, text);
+    schedule();
+}
+
+void WidgetUpdater::setChecked (QAbstractButton* button, bool checked)
+{
+    m_checks.insert (button, checked);
+    schedule();
+}
+
+void WidgetUpdater::schedule()
+{
+    if (!m_scheduled) {
+        m_scheduled = true;
+        QTimer::singleShot (_FRAME_INTERVAL, this, SLOT (apply()));
+    }
+}
+
+void WidgetUpdater::apply()
+{
+    m_scheduled = false;
+
+    QHash<QLabel*, QString>::const_iterator text;
+    for (text = m_texts.constBegin(); text != m_texts.constEnd(); ++text) {
+        if (text.key()->text() != text.value())
+            text.key()->setText (text.value());
+    }
+
+    QHash<QAbstractButton*, bool>::const_iterator check;
+    for (check = m_checks.constBegin(); check != m_checks.constEnd(); ++check) {
+        if (check.key()->isChecked() != check.value())
+            check.key()->setChecked (check.value());
+    }
+
+    m_texts.clear();
+    m_checks.clear();
+}
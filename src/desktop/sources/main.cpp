@@ -28,9 +28,11 @@
 #include <QFontDatabase>
 #include <QStyleFactory>
 
+#include "Startup.h"
 #include "Settings.h"
 #include "MainWindow.h"
 #include "AssemblyInfo.h"
+#include "AdvancedSettings.h"
 
 /*
  * Custom appearance options for each operating system
@@ -68,6 +70,9 @@ int main (int argc, char* argv[]);
  */
 int main (int argc, char* argv[])
 {
+    Startup* startup = Startup::getInstance();
+
+    startup->beginPhase ("Application");
     QApplication app (argc, argv);
     app.setStyle (_APP_STLYE_CODE);
     app.setWindowIcon (_APP_ICON_CODE);
@@ -75,13 +80,20 @@ int main (int argc, char* argv[])
     app.setApplicationVersion (AssemblyInfo::version());
     app.setOrganizationName (AssemblyInfo::organization());
 
+    startup->beginPhase ("Translator");
     loadTranslator();
+
+    startup->beginPhase ("Fonts and colors");
     loadApplicationFont();
+    AdvancedSettings::loadApplicationColors();
 
     /* The window will show itself when initialized */
     MainWindow window;
     Q_UNUSED (window);
 
+    /* Run the deferred tasks once the event loop is running */
+    startup->finish();
+
     return app.exec();
 }
 
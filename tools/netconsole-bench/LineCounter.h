@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef _NETCONSOLE_BENCH_LINE_COUNTER_H
+#define _NETCONSOLE_BENCH_LINE_COUNTER_H
+
+#include <QList>
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+
+/**
+ * @class LineCounter
+ * @brief Counts the benchmark lines emitted by the NetConsole
+ *
+ * The counter is connected directly to the NetConsole, so it runs in the
+ * NetConsole thread and measures the worker alone, without any event loop
+ * between the worker and the counter.
+ */
+class LineCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LineCounter (const QByteArray& prefix) : m_prefix (prefix)
+    {
+        m_lines.store (0);
+    }
+
+    /**
+     * Returns the number of benchmark lines received so far
+     */
+    int lines()
+    {
+        return m_lines.load();
+    }
+
+public slots:
+    /**
+     * Counts the \a messages that were generated by the benchmark
+     */
+    void count (QList<QByteArray> messages)
+    {
+        int count = 0;
+        foreach (const QByteArray& message, messages) {
+            if (message.startsWith (m_prefix))
+                ++count;
+        }
+
+        m_lines.fetchAndAddOrdered (count);
+    }
+
+private:
+    QByteArray m_prefix;
+    QAtomicInt m_lines;
+};
+
+#endif /* _NETCONSOLE_BENCH_LINE_COUNTER_H */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QThread>
+#include <QUdpSocket>
+#include <QMetaObject>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "NetConsole.h"
+#include "LineCounter.h"
+
+/* The port in which the NetConsole listens for the robot messages */
+#define _UDP_IN_PORT 6666
+
+/* Sustained ingest rate that the NetConsole worker must reach */
+#define _TARGET_RATE 100000
+
+/* Default number of lines and bytes per line sent by the benchmark */
+#define _DEFAULT_LINES 1000000
+#define _DEFAULT_SIZE 64
+
+/* Lines that can be in flight, the kernel drops datagrams above this */
+#define _WINDOW 256
+
+/* Milliseconds without progress after which the lines in flight are lost */
+#define _STALL_TIMEOUT 100
+
+/* The benchmark ends after this many milliseconds without new lines */
+#define _IDLE_TIMEOUT 500
+
+/* Every line begins with this prefix so that it can be told apart */
+#define _PREFIX "bench: "
+
+/**
+ * Waits until the counter stops changing and returns the time of the last
+ * change, as measured by the given \a timer
+ */
+static qint64 waitForLastLine (LineCounter* counter, const QElapsedTimer& timer)
+{
+    int lines = counter->lines();
+    qint64 lastChange = timer.elapsed();
+
+    while (timer.elapsed() - lastChange < _IDLE_TIMEOUT) {
+        QThread::msleep (1);
+
+        if (counter->lines() != lines) {
+            lines = counter->lines();
+            lastChange = timer.elapsed();
+        }
+    }
+
+    return lastChange;
+}
+
+/**
+ * Usage: netconsole-bench [lines] [bytes per line]
+ */
+int main (int argc, char* argv[])
+{
+    QCoreApplication app (argc, argv);
+
+    int count = argc > 1 ? atoi (argv[1]) : _DEFAULT_LINES;
+    int size = argc > 2 ? atoi (argv[2]) : _DEFAULT_SIZE;
+    size = qMax (size, (int) sizeof (_PREFIX) + 8);
+
+    /* Every line must be emitted, do not sample them */
+    NetConsole* console = NetConsole::getInstance();
+    console->setMessageBudget (0);
+
+    LineCounter counter (_PREFIX);
+    QObject::connect (console,  SIGNAL (newMessages (QList<QByteArray>)),
+                      &counter, SLOT   (count       (QList<QByteArray>)),
+                      Qt::DirectConnection);
+
+    QMetaObject::invokeMethod (console, "init", Qt::BlockingQueuedConnection);
+
+    QUdpSocket socket;
+    QByteArray line (size, 'x');
+    QHostAddress address (QHostAddress::LocalHost);
+
+    int sent = 0;
+    int lost = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (; sent < count; ++sent) {
+        /* Every line is different, otherwise they are collapsed */
+        QByteArray number = QByteArray::number (sent).rightJustified (8, '0');
+        line.replace (0, sizeof (_PREFIX) - 1, _PREFIX);
+        line.replace (sizeof (_PREFIX) - 1, number.length(), number);
+
+        if (socket.writeDatagram (line, address, _UDP_IN_PORT) != size) {
+            fprintf (stderr, "Cannot send to port %d\n", _UDP_IN_PORT);
+            return EXIT_FAILURE;
+        }
+
+        /* Do not send faster than the worker reads */
+        QElapsedTimer stall;
+        stall.start();
+        while (sent + 1 - lost - counter.lines() > _WINDOW) {
+            if (stall.elapsed() > _STALL_TIMEOUT) {
+                lost = sent + 1 - counter.lines();
+                break;
+            }
+
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    qint64 elapsed = qMax (waitForLastLine (&counter, timer), (qint64) 1);
+
+    int accepted = counter.lines();
+    qint64 rate = accepted * (qint64) 1000 / elapsed;
+
+    printf ("Sent:     %d lines of %d bytes\n", sent, size);
+    printf ("Accepted: %d lines\n", accepted);
+    printf ("Lost:     %d lines\n", sent - accepted);
+    printf ("Time:     %lld ms\n", (long long) elapsed);
+    printf ("Rate:     %lld lines/s (target %d lines/s)\n",
+            (long long) rate, _TARGET_RATE);
+
+    return rate >= _TARGET_RATE ? EXIT_SUCCESS : EXIT_FAILURE;
+}
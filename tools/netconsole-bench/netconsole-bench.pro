@@ -0,0 +1,51 @@
+#
+# This file is part of QDriverStation
+#
+# Copyright (c) 2015 WinT 3794 <http:/wint3794.org>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+#-------------------------------------------------------------------------------
+# Floods the NetConsole input port and reports how many lines per second the
+# NetConsole worker accepts, without a GUI
+#-------------------------------------------------------------------------------
+
+TEMPLATE = app
+TARGET = netconsole-bench
+
+QT += core
+QT += network
+QT -= gui
+CONFIG += console
+CONFIG += c++11
+CONFIG -= app_bundle
+
+QMAKE_CXXFLAGS_RELEASE -= -O2
+QMAKE_CXXFLAGS_RELEASE += -O3
+
+INCLUDEPATH += $$PWD/../../lib/DriverStation/src
+
+HEADERS += \
+    $$PWD/../../lib/DriverStation/src/NetConsole.h \
+    $$PWD/LineCounter.h
+
+SOURCES += \
+    $$PWD/../../lib/DriverStation/src/NetConsole.cpp \
+    $$PWD/main.cpp
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2015 WinT 3794 <http://wint3794.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <QList>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Packets.h"
+
+/* The joystick limits of the FRC 2015 protocol */
+#define _MAX_JOYSTICKS 6
+#define _MAX_AXES 12
+#define _MAX_BUTTONS 32
+#define _MAX_POVS 4
+
+/* Default number of packets encoded by the benchmark */
+#define _DEFAULT_ITERATIONS 1000000
+
+/* Number of random values checked against the portable conversion */
+#define _RANDOM_VALUES 65536
+
+/* Keeps the compiler from removing the benchmarked code */
+static volatile int sink = 0;
+
+/**
+ * Returns a pseudo-random value between -4 and 4, the sequence is the same
+ * in every run so that failures can be reproduced
+ */
+static double randomValue (quint32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / (double) (1 << 24) * 8 - 4;
+}
+
+/**
+ * Converts the \a count values of \a input with both versions of the axis
+ * conversion and reports the values in which they differ
+ */
+static int compare (const double* input, int count)
+{
+    qint8 simd[_RANDOM_VALUES];
+    qint8 scalar[_RANDOM_VALUES];
+
+    DS_QuantizeAxes (input, simd, count);
+    DS_QuantizeAxesScalar (input, scalar, count);
+
+    int errors = 0;
+    for (int i = 0; i < count; ++i) {
+        if (simd[i] != scalar[i]) {
+            printf ("Mismatch: %g gives %d (SSE2) and %d (portable)\n",
+                    input[i], simd[i], scalar[i]);
+            ++errors;
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * Checks that the SSE2 and portable conversions agree on special values
+ * (NaN, infinities, out of range and rounding boundaries) in every lane of
+ * a batch, on random values, and that special values give the expected
+ * results
+ */
+static bool checkParity()
+{
+    const double specials[] = {
+        NAN, -NAN, INFINITY, -INFINITY, 0.0, -0.0, 1, -1, 2, -2,
+        1 + DBL_EPSILON, -1 - DBL_EPSILON, 1e300, -1e300, DBL_MIN, -DBL_MIN,
+        DBL_MAX, -DBL_MAX, 0.5, -0.5, 1.0 / 127, -1.0 / 127,
+        126.5 / 127, -126.5 / 127, 1 - DBL_EPSILON, -1 + DBL_EPSILON
+    };
+
+    const int count = sizeof (specials) / sizeof (specials[0]);
+    int errors = 0;
+
+    /* Put each special value in each lane, followed by a partial batch */
+    for (int i = 0; i < count; ++i) {
+        for (int lane = 0; lane < 4; ++lane) {
+            double input[7] = {0.25, -0.25, 0.75, -0.75, 0.1, -0.1, 0.9};
+            input[lane] = specials[i];
+            input[4 + lane % 3] = specials[i];
+            errors += compare (input, 7);
+        }
+    }
+
+    /* Random values, with a special value every 97 values */
+    static double values[_RANDOM_VALUES];
+    quint32 seed = 3794;
+    for (int i = 0; i < _RANDOM_VALUES; ++i) {
+        values[i] = randomValue (seed);
+        if (i % 97 == 0)
+            values[i] = specials[(i / 97) % count];
+    }
+
+    errors += compare (values, _RANDOM_VALUES);
+
+    /* The special values must be sent as the protocol expects */
+    const double inputs[] = {NAN, INFINITY, -INFINITY, 2, -2, 1, -1, 0};
+    const qint8 expected[] = {0, 127, -127, 127, -127, 127, -127, 0};
+
+    qint8 output[8];
+    DS_QuantizeAxes (inputs, output, 8);
+    for (int i = 0; i < 8; ++i) {
+        if (output[i] != expected[i]) {
+            printf ("Wrong value: %g gives %d instead of %d\n",
+                    inputs[i], output[i], expected[i]);
+            ++errors;
+        }
+    }
+
+    printf ("Parity:   %s (%d special values, %d random values)\n",
+            errors == 0 ? "OK" : "FAILED", count, _RANDOM_VALUES);
+
+    return errors == 0;
+}
+
+/**
+ * Returns six joysticks with the largest number of inputs allowed
+ */
+static QList<DS_JoystickData> createJoysticks()
+{
+    QList<DS_JoystickData> joysticks;
+
+    for (int i = 0; i < _MAX_JOYSTICKS; ++i) {
+        DS_JoystickData joystick;
+
+        for (int j = 0; j < _MAX_AXES; ++j)
+            joystick.axes.append ((i * _MAX_AXES + j) / 36.0 - 1);
+
+        for (int j = 0; j < _MAX_BUTTONS; ++j)
+            joystick.buttons.append ((i + j) % 3 == 0);
+
+        for (int j = 0; j < _MAX_POVS; ++j)
+            joystick.povs.append (j == 0 ? 90 * i : -1);
+
+        joysticks.append (joystick);
+    }
+
+    return joysticks;
+}
+
+/**
+ * Usage: packets-bench [iterations]
+ */
+int main (int argc, char* argv[])
+{
+    int iterations = argc > 1 ? atoi (argv[1]) : _DEFAULT_ITERATIONS;
+    iterations = qMax (iterations, 1);
+
+#if defined __SSE2__
+    printf ("Build:    SSE2\n");
+#else
+    printf ("Build:    portable only\n");
+#endif
+
+    if (!checkParity())
+        return EXIT_FAILURE;
+
+    QElapsedTimer timer;
+
+    /* Conversion of all the axes of six joysticks */
+    double axes[_MAX_JOYSTICKS * _MAX_AXES];
+    qint8 bytes[_MAX_JOYSTICKS * _MAX_AXES];
+    for (int i = 0; i < _MAX_JOYSTICKS * _MAX_AXES; ++i)
+        axes[i] = i / 36.0 - 1;
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        axes[i % (_MAX_JOYSTICKS * _MAX_AXES)] = (i % 255) / 127.0 - 1;
+        DS_QuantizeAxes (axes, bytes, _MAX_JOYSTICKS * _MAX_AXES);
+        sink += bytes[i % (_MAX_JOYSTICKS * _MAX_AXES)];
+    }
+
+    qint64 quantize = timer.nsecsElapsed();
+
+    /* Encoding of whole control packets */
+    QList<DS_JoystickData> joysticks = createJoysticks();
+    int size = 0;
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        joysticks[i % _MAX_JOYSTICKS].axes[0] = (i % 255) / 127.0 - 1;
+
+        QByteArray packet = DS_CommonControlPacket (i, DS_Ok, DS_Red1,
+                                                    DS_TeleOp, joysticks);
+        size = packet.length();
+        sink += packet.at (i % size);
+    }
+
+    qint64 encode = timer.nsecsElapsed();
+
+    printf ("Axes:     %.1f ns per batch of %d axes\n",
+            quantize / (double) iterations, _MAX_JOYSTICKS * _MAX_AXES);
+    printf ("Packet:   %.1f ns per packet of %d bytes (%d joysticks)\n",
+            encode / (double) iterations, size, _MAX_JOYSTICKS);
+    printf ("Rate:     %.0f packets/s\n",
+            iterations / (encode / 1e9));
+
+    return EXIT_SUCCESS;
+}